@@ -9,6 +9,28 @@
 #include <algorithm>
 #include <ctime>
 #include <limits>
+#include <cstdint>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <filesystem>
+#include <charconv>
+#include <unordered_set>
+#include <chrono>
+#include <iterator>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#ifdef _WIN32
+    #define NOMINMAX
+    #include <windows.h>
+    #include <io.h>
+    #include <intrin.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
 using namespace std;
 
 void clearScreen() {
@@ -19,28 +41,96 @@ void clearScreen() {
     #endif
 }
 
-void pause() {
+void pauseScreen() {
     cout << "\nPress Enter to continue...";
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     cin.get();
 }
 
-vector<vector<string>> readCSV(const string& filename) {
-    vector<vector<string>> data;
-    ifstream file(filename);
-    string line;
+// Read-only memory mapping of a whole file. An empty or missing file maps
+// to an empty view.
+class MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+public:
+    explicit MappedFile(const string& filename) {
+#ifdef _WIN32
+        file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                           nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER len;
+        if (!GetFileSizeEx(file, &len) || len.QuadPart == 0) return;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return;
+        data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (data) size = static_cast<size_t>(len.QuadPart);
+#else
+        FILE* f = fopen(filename.c_str(), "rb");
+        if (!f) return;
+        struct stat st;
+        if (fstat(fileno(f), &st) == 0 && st.st_size > 0) {
+            void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+            if (p != MAP_FAILED) {
+                data = static_cast<const char*>(p);
+                size = static_cast<size_t>(st.st_size);
+                madvise(p, size, MADV_SEQUENTIAL);
+            }
+        }
+        fclose(f);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (data) munmap(const_cast<char*>(data), size);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    string_view view() const { return string_view(data, size); }
+};
 
-    while (getline(file, line)) {
-        if(line.empty()) continue;
-        vector<string> row;
-        size_t pos = 0;
-        while ((pos = line.find(',')) != string::npos) {
-            row.push_back(line.substr(0, pos));
-            line.erase(0, pos + 1);
+// Calls visit(fields) for every non-empty line of a CSV file. Fields are
+// views into the mapping and are only valid during the call.
+template <typename Visitor>
+void forEachCSVRow(const string& filename, Visitor visit) {
+    MappedFile file(filename);
+    string_view rest = file.view();
+    vector<string_view> fields;
+
+    while (!rest.empty()) {
+        size_t eol = rest.find('\n');
+        string_view line = rest.substr(0, eol);
+        rest.remove_prefix(eol == string_view::npos ? rest.size() : eol + 1);
+        if (line.empty()) continue;
+
+        fields.clear();
+        size_t start = 0, comma;
+        while ((comma = line.find(',', start)) != string_view::npos) {
+            fields.push_back(line.substr(start, comma - start));
+            start = comma + 1;
         }
-        row.push_back(line);
-        data.push_back(row);
+        fields.push_back(line.substr(start));
+        visit(fields);
     }
+}
+
+vector<vector<string>> readCSV(const string& filename) {
+    vector<vector<string>> data;
+    forEachCSVRow(filename, [&](const vector<string_view>& fields) {
+        data.emplace_back(fields.begin(), fields.end());
+    });
     return data;
 }
 
@@ -55,6 +145,880 @@ void writeCSV(const string& filename, const vector<vector<string>>& data) {
     }
 }
 
+// Built-in grades, then Unknown for an empty grade. Any other grade text is
+// interned by parseGrade() with a code above Unknown, so gradeName() shows
+// it exactly as grades.csv has it.
+enum class Grade : uint16_t { APlus, A, BPlus, B, CPlus, C, D, F, Unknown };
+
+constexpr float gradePointTable[] = { 4.0f, 3.75f, 3.5f, 3.0f, 2.5f, 2.0f, 1.5f, 0.0f };
+
+constexpr bool isBuiltinGrade(Grade g) { return g < Grade::Unknown; }
+
+constexpr float gradePoint(Grade g) { return isBuiltinGrade(g) ? gradePointTable[static_cast<uint16_t>(g)] : 0.0f; }
+
+// Grade text that is not a built-in name, in order of first appearance. A
+// deque keeps the strings in place, so gradeName() can return c_str().
+deque<string> internedGrades;
+unordered_map<string, uint16_t> internedGradeCodes;
+constexpr uint16_t firstInternedGrade = static_cast<uint16_t>(Grade::Unknown) + 1;
+
+Grade parseGrade(string_view grade) {
+    if (!grade.empty() && grade.back() == '\r') grade.remove_suffix(1);
+    if (grade.empty()) return Grade::Unknown;
+
+    Grade g = Grade::Unknown;
+    if (grade.size() <= 2) {
+        bool plus = grade.size() == 2;
+        if (!plus || grade[1] == '+') {
+            switch (grade[0]) {
+                case 'A': g = plus ? Grade::APlus : Grade::A; break;
+                case 'B': g = plus ? Grade::BPlus : Grade::B; break;
+                case 'C': g = plus ? Grade::CPlus : Grade::C; break;
+                case 'D': g = plus ? Grade::Unknown : Grade::D; break;
+                case 'F': g = plus ? Grade::Unknown : Grade::F; break;
+            }
+        }
+    }
+    if (g != Grade::Unknown) return g;
+
+    auto it = internedGradeCodes.find(string(grade));
+    if (it != internedGradeCodes.end()) return static_cast<Grade>(it->second);
+    if (internedGrades.size() >= 0xFFFFu - firstInternedGrade) return Grade::Unknown;
+    uint16_t code = static_cast<uint16_t>(firstInternedGrade + internedGrades.size());
+    internedGrades.emplace_back(grade);
+    internedGradeCodes.emplace(internedGrades.back(), code);
+    return static_cast<Grade>(code);
+}
+
+const char* gradeName(Grade g) {
+    static const char* const names[] = { "A+", "A", "B+", "B", "C+", "C", "D", "F", "" };
+    uint16_t code = static_cast<uint16_t>(g);
+    return code < firstInternedGrade ? names[code] : internedGrades[code - firstInternedGrade].c_str();
+}
+
+// Size and mtime of a file, used to notice when a cached copy is stale.
+struct FileStamp {
+    filesystem::file_time_type time{};
+    uintmax_t size = 0;
+
+    static FileStamp of(const string& filename) {
+        FileStamp stamp;
+        error_code ec;
+        filesystem::directory_entry entry(filename, ec);
+        if (entry.exists(ec)) {
+            stamp.time = entry.last_write_time(ec);
+            stamp.size = entry.file_size(ec);
+        }
+        return stamp;
+    }
+
+    bool operator==(const FileStamp& other) const { return time == other.time && size == other.size; }
+};
+
+bool syncFile(FILE* file) {
+    if (fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Log records are "<fields>,<checksum>\n", the checksum being 16 hex digits
+// of FNV-1a over the fields, so a line torn by a crash or a failed write is
+// recognised when the log is read back.
+uint64_t checksum(string_view s) {
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+void appendRecord(string& out, string_view body) {
+    char sum[18];
+    sum[0] = ',';
+    uint64_t h = checksum(body);
+    for (int i = 16; i >= 1; i--, h >>= 4) sum[i] = "0123456789abcdef"[h & 15];
+    sum[17] = '\n';
+    out += body;
+    out.append(sum, 18);
+}
+
+// Checks one record (without its newline) and returns its comma-separated
+// fields; false when the checksum does not match or the field count is not
+// `count`.
+bool readRecord(string_view line, size_t count, vector<string_view>& fields) {
+    size_t comma = line.rfind(',');
+    uint64_t sum = 0;
+    if (comma == string_view::npos || line.size() - comma - 1 != 16) return false;
+    auto parsed = from_chars(line.data() + comma + 1, line.data() + line.size(), sum, 16);
+    if (parsed.ec != errc() || parsed.ptr != line.data() + line.size()) return false;
+    string_view body = line.substr(0, comma);
+    if (sum != checksum(body)) return false;
+
+    fields.clear();
+    size_t start = 0, c;
+    while ((c = body.find(',', start)) != string_view::npos) {
+        fields.push_back(body.substr(start, c - start));
+        start = c + 1;
+    }
+    fields.push_back(body.substr(start));
+    return fields.size() == count;
+}
+
+// Write-ahead log for grades.csv. Each change sets one row, identified by
+// student and its position n among that student's rows in file order:
+// "student,n,course,grade,credits,checksum" in grades.wal. An n past the
+// student's last row appends one, and appends are logged with n equal to
+// the row count, so a record replayed onto a grades.csv that already has it
+// changes nothing.
+// upsert() returns once its record is fsynced; records that queue up while
+// the committer thread is syncing go out together with one fsync. The
+// checkpoint thread folds durable records into grades.csv every
+// checkpointInterval, or sooner once checkpointRecords have been logged,
+// and records left behind by a crash are folded in when the log is opened.
+class GradeWal {
+public:
+    struct Upsert {
+        uint64_t seq;
+        string student;
+        uint32_t row;               // position among the student's rows
+        string course, grade, credits;
+    };
+
+    static constexpr size_t checkpointRecords = 4096;
+    static constexpr chrono::seconds checkpointInterval{2};
+
+private:
+    mutex lock;
+    condition_variable commitWake, settledWake, checkpointWake;
+    vector<Upsert> pending;         // logged, not yet folded into grades.csv (seq order)
+    string queued;                  // encoded records waiting for the committer
+    uint64_t lastSeq = 0, settledSeq = 0;
+    vector<pair<uint64_t, uint64_t>> failedBatches;
+    size_t sinceCheckpoint = 0;
+    uint64_t logBytes = 0;
+    bool stopping = false;
+
+    mutex fileLock;                 // held while grades.wal is written or emptied
+    mutex checkpointLock;           // held by checkpoints and by GradesTable loads
+    FILE* log = nullptr;
+    thread committer, checkpointer;
+
+    // The last checkpoint: grades.csv went from `before` to `after` with
+    // every record up to foldedSeq in it.
+    FileStamp before, after;
+    uint64_t foldedSeq = 0;
+
+    bool failed(uint64_t seq) const {
+        for (const auto& [first, last] : failedBatches) {
+            if (seq >= first && seq <= last) return true;
+        }
+        return false;
+    }
+
+    // Reads back a previous run's log, drops a torn tail so new records are
+    // not appended after it, and folds the rest into grades.csv.
+    void replay() {
+        string data;
+        if (FILE* in = fopen("grades.wal", "rb")) {
+            char buf[1 << 16];
+            size_t n;
+            while ((n = fread(buf, 1, sizeof buf, in)) > 0) data.append(buf, n);
+            fclose(in);
+        }
+
+        size_t valid = 0;
+        vector<string_view> f;
+        while (valid < data.size()) {
+            size_t eol = data.find('\n', valid);
+            uint32_t row;
+            if (eol == string::npos || !readRecord(string_view(data).substr(valid, eol - valid), 5, f) ||
+                from_chars(f[1].data(), f[1].data() + f[1].size(), row).ec != errc()) {
+                break;
+            }
+            pending.push_back({++lastSeq, string(f[0]), row, string(f[2]), string(f[3]), string(f[4])});
+            valid = eol + 1;
+        }
+        settledSeq = lastSeq;
+        logBytes = valid;
+
+        error_code ec;
+        if (valid < data.size()) filesystem::resize_file("grades.wal", valid, ec);
+        log = fopen("grades.wal", "ab");
+        if (!pending.empty()) checkpoint();
+    }
+
+    void commitLoop() {
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            commitWake.wait(guard, [&] { return stopping || !queued.empty(); });
+            if (queued.empty()) return;
+
+            string batch;
+            batch.swap(queued);
+            uint64_t first = settledSeq + 1, last = lastSeq;
+            guard.unlock();
+
+            bool ok;
+            {
+                lock_guard<mutex> file(fileLock);
+                ok = log && fwrite(batch.data(), 1, batch.size(), log) == batch.size() && syncFile(log);
+                if (ok) {
+                    logBytes += batch.size();
+                } else if (log) {
+                    error_code ec;
+                    clearerr(log);
+                    filesystem::resize_file("grades.wal", logBytes, ec);
+                }
+            }
+
+            guard.lock();
+            if (ok) {
+                sinceCheckpoint += last - first + 1;
+            } else {
+                failedBatches.emplace_back(first, last);
+                pending.erase(remove_if(pending.begin(), pending.end(),
+                                        [&](const Upsert& u) { return u.seq >= first && u.seq <= last; }),
+                              pending.end());
+            }
+            settledSeq = last;
+            settledWake.notify_all();
+            if (sinceCheckpoint >= checkpointRecords) checkpointWake.notify_one();
+        }
+    }
+
+    void checkpointLoop() {
+        unique_lock<mutex> guard(lock);
+        while (!stopping) {
+            checkpointWake.wait_for(guard, checkpointInterval,
+                                    [&] { return stopping || sinceCheckpoint >= checkpointRecords; });
+            if (stopping || pending.empty()) continue;
+            guard.unlock();
+            checkpoint();
+            guard.lock();
+        }
+    }
+
+    GradeWal() {
+        replay();
+        committer = thread(&GradeWal::commitLoop, this);
+        checkpointer = thread(&GradeWal::checkpointLoop, this);
+    }
+
+public:
+    ~GradeWal() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        commitWake.notify_all();
+        checkpointWake.notify_all();
+        checkpointer.join();
+        committer.join();
+        checkpoint();
+        if (log) fclose(log);
+    }
+
+    static GradeWal& instance() {
+        static GradeWal wal;
+        return wal;
+    }
+
+    // Logs the change and waits until it is durable. Returns its sequence
+    // number, or 0 when the log could not be written.
+    uint64_t upsert(const string& student, uint32_t row, const string& course, const string& grade,
+                    const string& credits) {
+        for (const string* field : {&student, &course, &grade, &credits}) {
+            if (field->find_first_of(",\n") != string::npos) return 0;
+        }
+        string body = student + "," + to_string(row) + "," + course + "," + grade + "," + credits;
+
+        unique_lock<mutex> guard(lock);
+        uint64_t seq = ++lastSeq;
+        appendRecord(queued, body);
+        pending.push_back({seq, student, row, course, grade, credits});
+        commitWake.notify_one();
+        settledWake.wait(guard, [&] { return seq <= settledSeq; });
+        return failed(seq) ? 0 : seq;
+    }
+
+    // Calls f(upsert) for every record not yet folded into grades.csv and
+    // returns the sequence number of the last record logged.
+    template <typename F>
+    uint64_t forEachPending(F f) {
+        lock_guard<mutex> guard(lock);
+        for (const Upsert& u : pending) f(u);
+        return lastSeq;
+    }
+
+    // Runs f with checkpoints held off, so grades.csv and the pending
+    // records it reads describe the same state.
+    template <typename F>
+    void withoutCheckpoints(F f) {
+        lock_guard<mutex> guard(checkpointLock);
+        f();
+    }
+
+    // True when grades.csv went from `from` to `to` through the last
+    // checkpoint and every record it folded in is at or before `seq`.
+    bool rewrote(const FileStamp& from, const FileStamp& to, uint64_t seq) {
+        lock_guard<mutex> guard(checkpointLock);
+        return foldedSeq > 0 && from == before && to == after && foldedSeq <= seq;
+    }
+
+    // Folds every durable record into grades.csv (temporary file, fsync,
+    // rename) and empties the log when nothing in it is still pending.
+    bool checkpoint() {
+        lock_guard<mutex> checkpointGuard(checkpointLock);
+        vector<Upsert> batch;
+        {
+            lock_guard<mutex> guard(lock);
+            sinceCheckpoint = 0;
+            for (const Upsert& u : pending) {
+                if (u.seq <= settledSeq) batch.push_back(u);
+            }
+        }
+        if (batch.empty()) return true;
+
+        FileStamp from = FileStamp::of("grades.csv");
+        auto grades = readCSV("grades.csv");
+        unordered_map<string, vector<size_t>> rows;   // student -> row numbers, file order
+        for (size_t i = 0; i < grades.size(); i++) {
+            if (grades[i].size() >= 4) rows[grades[i][0]].push_back(i);
+        }
+        for (const Upsert& u : batch) {
+            auto& at = rows[u.student];
+            if (u.row >= at.size()) {
+                at.push_back(grades.size());
+                grades.push_back({u.student, u.course, u.grade, u.credits});
+            } else {
+                auto& row = grades[at[u.row]];
+                row[1] = u.course;
+                row[2] = u.grade;
+                row[3] = u.credits;
+            }
+        }
+
+        string buf;
+        for (const auto& row : grades) {
+            for (size_t i = 0; i < row.size(); ++i) {
+                buf += row[i];
+                buf += i + 1 < row.size() ? ',' : '\n';
+            }
+        }
+        FILE* out = fopen("grades.csv.tmp", "wb");
+        if (!out) return false;
+        bool ok = fwrite(buf.data(), 1, buf.size(), out) == buf.size();
+        ok = syncFile(out) && ok;
+        ok = fclose(out) == 0 && ok;
+        error_code ec;
+        if (ok) filesystem::rename("grades.csv.tmp", "grades.csv", ec);
+        if (!ok || ec) return false;
+
+        before = from;
+        after = FileStamp::of("grades.csv");
+        foldedSeq = batch.back().seq;
+
+        lock_guard<mutex> file(fileLock);
+        lock_guard<mutex> guard(lock);
+        pending.erase(pending.begin(), find_if(pending.begin(), pending.end(),
+                                               [&](const Upsert& u) { return u.seq > foldedSeq; }));
+        if (pending.empty() && queued.empty() && settledSeq == lastSeq && logBytes > 0) {
+            filesystem::resize_file("grades.wal", 0, ec);
+            if (!ec) logBytes = 0;
+        }
+        return true;
+    }
+};
+
+// grades.csv held as columns. Student and course names are dictionary
+// encoded and rows are grouped by student (file order kept), so one
+// student's grades are the contiguous range rowStart[id]..rowStart[id+1].
+// Grade points and credits are also summed per student, so a CGPA is read
+// without walking the rows. Records still in the grade log are laid over
+// the file on load, and upsert() applies new ones in place.
+class GradesTable {
+    deque<string> studentNames, courseNames;
+    unordered_map<string_view, uint32_t> studentIds, courseIds;
+
+    vector<uint32_t> course;
+    vector<Grade> grade;
+    vector<int16_t> credits;       // -1 when not a number
+    vector<uint32_t> rowStart;     // studentNames.size() + 1 entries
+
+    // Per student. Every grade point is a multiple of 0.25, so points are
+    // summed as whole quarter points and never drift across edits.
+    vector<int64_t> quarterPoints;
+    vector<int32_t> creditTotal;
+
+    FileStamp loadedStamp;
+    uint64_t appliedSeq = 0;       // last grade log record reflected in the table
+    bool loaded = false;
+
+    static uint32_t intern(string_view name, deque<string>& names,
+                           unordered_map<string_view, uint32_t>& ids) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        names.emplace_back(name);
+        uint32_t id = static_cast<uint32_t>(names.size() - 1);
+        ids.emplace(names.back(), id);
+        return id;
+    }
+
+    static int16_t parseCredits(string_view c) {
+        while (!c.empty() && c.front() == ' ') c.remove_prefix(1);
+        int value = -1;
+        if (from_chars(c.data(), c.data() + c.size(), value).ec != errc() || value < 0) value = -1;
+        return static_cast<int16_t>(min(value, 32767));
+    }
+
+    // Adds (sign 1) or removes (sign -1) a row's share of its student's totals.
+    void count(uint32_t student, uint32_t row, int sign) {
+        if (credits[row] < 0) return;
+        quarterPoints[student] += sign * static_cast<int64_t>(gradePoint(grade[row]) * 4) * credits[row];
+        creditTotal[student] += sign * credits[row];
+    }
+
+    void load() {
+        studentNames.clear(); courseNames.clear();
+        studentIds.clear(); courseIds.clear();
+
+        vector<uint32_t> rowStudent, rowCourse;
+        vector<Grade> rowGrade;
+        vector<int16_t> rowCredits;
+        forEachCSVRow("grades.csv", [&](const vector<string_view>& g) {
+            if (g.size() < 4) return;
+            rowStudent.push_back(intern(g[0], studentNames, studentIds));
+            rowCourse.push_back(intern(g[1], courseNames, courseIds));
+            rowGrade.push_back(parseGrade(g[2]));
+            rowCredits.push_back(parseCredits(g[3]));
+        });
+
+        // Counting sort by student; stable, so each student's rows stay in file order.
+        rowStart.assign(studentNames.size() + 1, 0);
+        for (uint32_t s : rowStudent) rowStart[s + 1]++;
+        for (size_t i = 1; i < rowStart.size(); i++) rowStart[i] += rowStart[i - 1];
+
+        vector<uint32_t> next(rowStart.begin(), rowStart.end() - 1);
+        course.resize(rowStudent.size());
+        grade.resize(rowStudent.size());
+        credits.resize(rowStudent.size());
+        for (size_t r = 0; r < rowStudent.size(); r++) {
+            uint32_t at = next[rowStudent[r]]++;
+            course[at] = rowCourse[r];
+            grade[at] = rowGrade[r];
+            credits[at] = rowCredits[r];
+        }
+
+        quarterPoints.assign(studentNames.size(), 0);
+        creditTotal.assign(studentNames.size(), 0);
+        for (uint32_t s = 0; s < studentNames.size(); s++) {
+            for (uint32_t r = rowStart[s]; r < rowStart[s + 1]; r++) count(s, r, 1);
+        }
+
+        appliedSeq = GradeWal::instance().forEachPending([&](const GradeWal::Upsert& u) {
+            upsert(u.student, u.row, u.course, u.grade, u.credits, u.seq);
+        });
+    }
+
+public:
+    static GradesTable& instance() {
+        static GradesTable table;
+        table.refresh();
+        return table;
+    }
+
+    // Reloads when grades.csv has been rewritten since the last load, unless
+    // the rewrite was a checkpoint of records the table already has.
+    void refresh() {
+        GradeWal& wal = GradeWal::instance();
+        FileStamp stamp = FileStamp::of("grades.csv");
+        if (loaded && (stamp == loadedStamp || wal.rewrote(loadedStamp, stamp, appliedSeq))) {
+            loadedStamp = stamp;
+            return;
+        }
+        wal.withoutCheckpoints([&] {
+            loadedStamp = FileStamp::of("grades.csv");
+            load();
+        });
+        loaded = true;
+    }
+
+    // Row range [first, last) for a student; empty when they have no grades.
+    pair<uint32_t, uint32_t> rowsFor(const string& student) const {
+        auto it = studentIds.find(student);
+        if (it == studentIds.end()) return {0, 0};
+        return {rowStart[it->second], rowStart[it->second + 1]};
+    }
+
+    const string& courseName(uint32_t row) const { return courseNames[course[row]]; }
+    Grade gradeAt(uint32_t row) const { return grade[row]; }
+    int creditsAt(uint32_t row) const { return credits[row]; }
+
+    float cgpa(const string& student) const {
+        auto it = studentIds.find(student);
+        if (it == studentIds.end() || creditTotal[it->second] <= 0) return 0.0f;
+        return static_cast<float>(quarterPoints[it->second] / (4.0 * creditTotal[it->second]));
+    }
+
+    // The student's n-th row (in file order) takes the new values, or a row
+    // is appended when n is past their last one.
+    void setRow(const string& student, uint32_t n, string_view courseName, string_view gradeText,
+                string_view creditsText) {
+        uint32_t id = intern(student, studentNames, studentIds);
+        if (id + 1 == rowStart.size()) {
+            rowStart.push_back(rowStart.back());
+            quarterPoints.push_back(0);
+            creditTotal.push_back(0);
+        }
+
+        uint32_t r = rowStart[id] + n;
+        if (r >= rowStart[id + 1]) {
+            r = rowStart[id + 1];
+            course.insert(course.begin() + r, 0);
+            grade.insert(grade.begin() + r, Grade::Unknown);
+            credits.insert(credits.begin() + r, -1);
+            for (size_t s = id + 1; s < rowStart.size(); s++) rowStart[s]++;
+        }
+
+        count(id, r, -1);
+        course[r] = intern(courseName, courseNames, courseIds);
+        grade[r] = parseGrade(gradeText);
+        credits[r] = parseCredits(creditsText);
+        count(id, r, 1);
+    }
+
+    // Applies grade log record `seq` to the student's n-th row, the way a
+    // checkpoint folds it into grades.csv.
+    void upsert(const string& student, uint32_t n, const string& courseName, const string& gradeText,
+                const string& creditsText, uint64_t seq) {
+        setRow(student, n, courseName, gradeText, creditsText);
+        appliedSeq = max(appliedSeq, seq);
+    }
+};
+
+// Attendance keyed by (course, date, student). attendance.csv is the
+// snapshot; every mark since the last export is appended to attendance.log
+// and replayed on load, so marking a student never rewrites the CSV.
+class AttendanceStore {
+public:
+    struct Record {
+        string student, course, date, status;
+    };
+
+private:
+    vector<Record> records;
+    unordered_map<string, size_t> index;
+    FILE* journal = nullptr;
+    uintmax_t journalBytes = 0;     // whole records in attendance.log
+    uint64_t changes = 0;
+
+    static string key(const string& course, const string& date, const string& student) {
+        string k;
+        k.reserve(course.size() + date.size() + student.size() + 2);
+        k += course; k += '\x1f'; k += date; k += '\x1f'; k += student;
+        return k;
+    }
+
+    void apply(const string& student, const string& course, const string& date, const string& status) {
+        auto [it, inserted] = index.emplace(key(course, date, student), records.size());
+        if (inserted) records.push_back({student, course, date, status});
+        else records[it->second].status = status;
+        changes++;
+    }
+
+    void load() {
+        forEachCSVRow("attendance.csv", [&](const vector<string_view>& r) {
+            if (r.size() >= 4) apply(string(r[0]), string(r[1]), string(r[2]), string(r[3]));
+        });
+        replayJournal();
+    }
+
+    // Applies every intact record in attendance.log and cuts off a torn
+    // tail, so later marks are not appended onto half a line.
+    void replayJournal() {
+        size_t valid = 0, size = 0;
+        {
+            MappedFile file("attendance.log");
+            string_view data = file.view();
+            size = data.size();
+            vector<string_view> r;
+            while (valid < data.size()) {
+                size_t eol = data.find('\n', valid);
+                if (eol == string_view::npos || !readRecord(data.substr(valid, eol - valid), 4, r)) break;
+                apply(string(r[0]), string(r[1]), string(r[2]), string(r[3]));
+                valid = eol + 1;
+            }
+        }
+        error_code ec;
+        if (valid < size) filesystem::resize_file("attendance.log", valid, ec);
+        journalBytes = filesystem::exists("attendance.log", ec) ? filesystem::file_size("attendance.log", ec) : 0;
+        if (ec) journalBytes = 0;
+    }
+
+    AttendanceStore() { load(); }
+
+public:
+    ~AttendanceStore() {
+        if (journal) fclose(journal);
+    }
+
+    static AttendanceStore& instance() {
+        static AttendanceStore store;
+        return store;
+    }
+
+    // O(1) insert-or-update, made durable by one fsynced journal line.
+    bool upsert(const string& student, const string& course, const string& date, const string& status) {
+        for (const string* field : {&student, &course, &date, &status}) {
+            if (field->find_first_of(",\n") != string::npos) return false;
+        }
+        if (!journal) journal = fopen("attendance.log", "ab");
+        if (!journal) return false;
+        string line;
+        appendRecord(line, student + "," + course + "," + date + "," + status);
+        if (fwrite(line.data(), 1, line.size(), journal) != line.size() || !syncFile(journal)) {
+            // Drop the partial record and reopen on the next mark.
+            fclose(journal);
+            journal = nullptr;
+            error_code ec;
+            filesystem::resize_file("attendance.log", journalBytes, ec);
+            return false;
+        }
+        journalBytes += line.size();
+        apply(student, course, date, status);
+        return true;
+    }
+
+    const string* status(const string& course, const string& date, const string& student) const {
+        auto it = index.find(key(course, date, student));
+        return it == index.end() ? nullptr : &records[it->second].status;
+    }
+
+    const vector<Record>& all() const { return records; }
+    uint64_t version() const { return changes; }
+
+    // Folds the journal into attendance.csv and starts a fresh journal.
+    bool exportCSV() {
+        FILE* out = fopen("attendance.csv.tmp", "wb");
+        if (!out) return false;
+        string buf;
+        bool ok = true;
+        for (const auto& r : records) {
+            buf += r.student; buf += ','; buf += r.course; buf += ',';
+            buf += r.date; buf += ','; buf += r.status; buf += '\n';
+            if (buf.size() >= (1 << 20)) {
+                ok = fwrite(buf.data(), 1, buf.size(), out) == buf.size() && ok;
+                buf.clear();
+            }
+        }
+        ok = fwrite(buf.data(), 1, buf.size(), out) == buf.size() && ok;
+        ok = syncFile(out) && ok;
+        ok = fclose(out) == 0 && ok;
+
+        // A short write anywhere keeps the old file and the journal.
+        error_code ec;
+        if (ok) filesystem::rename("attendance.csv.tmp", "attendance.csv", ec);
+        else filesystem::remove("attendance.csv.tmp", ec);
+        if (!ok || ec) return false;
+
+        if (journal) fclose(journal);
+        journal = fopen("attendance.log", "wb");
+        journalBytes = 0;
+        return journal != nullptr;
+    }
+};
+
+inline int popcount64(uint64_t x) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(x));
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+inline int lowestBit(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return static_cast<int>(i);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// Attendance packed into bitmaps, one row per (course, student) over the
+// course's sessions: which sessions the student was recorded in and which
+// they were present at. A rate is then two popcounts over the row's words,
+// and the below-threshold scan is one pass over every row.
+class AttendanceBitmaps {
+public:
+    struct Rate {
+        uint32_t attended = 0, held = 0;
+        double percent() const { return held ? 100.0 * attended / held : 0.0; }
+    };
+
+    struct Alert {
+        const string* student;
+        const string* course;
+        Rate rate;
+    };
+
+private:
+    struct CourseBits {
+        vector<uint32_t> sessionDate;            // bit k of a row is session k (first-seen order)
+        unordered_map<uint32_t, uint32_t> rowOf; // student id -> row
+        vector<uint32_t> rowStudent;
+        size_t words = 0;
+        vector<uint64_t> present, recorded;      // row-major, `words` words per row
+
+        Rate rate(uint32_t row) const {
+            Rate r;
+            for (size_t w = row * words; w < (row + 1) * words; w++) {
+                r.attended += popcount64(present[w]);
+                r.held += popcount64(recorded[w]);
+            }
+            return r;
+        }
+    };
+
+    vector<string> students, courses, dates;
+    unordered_map<string, uint32_t> studentIds, courseIds, dateIds;
+    vector<CourseBits> courseBits;
+    uint64_t builtFrom = 0;
+    bool built = false;
+
+    static uint32_t intern(const string& name, vector<string>& names, unordered_map<string, uint32_t>& ids) {
+        auto [it, inserted] = ids.emplace(name, static_cast<uint32_t>(names.size()));
+        if (inserted) names.push_back(name);
+        return it->second;
+    }
+
+    void build(const AttendanceStore& store) {
+        *this = AttendanceBitmaps();
+        unordered_map<string, uint32_t> sessionIds;    // course \x1f date -> bit within the course
+        const auto& records = store.all();
+        vector<uint32_t> recordCourse, recordSession, recordRow;
+        recordCourse.reserve(records.size());
+        recordSession.reserve(records.size());
+        recordRow.reserve(records.size());
+
+        for (const auto& r : records) {
+            uint32_t course = intern(r.course, courses, courseIds);
+            if (courseBits.size() <= course) courseBits.resize(course + 1);
+            CourseBits& c = courseBits[course];
+            auto [session, inserted] = sessionIds.emplace(r.course + '\x1f' + r.date,
+                                                          static_cast<uint32_t>(c.sessionDate.size()));
+            if (inserted) c.sessionDate.push_back(intern(r.date, dates, dateIds));
+            uint32_t student = intern(r.student, students, studentIds);
+            auto [row, added] = c.rowOf.emplace(student, static_cast<uint32_t>(c.rowStudent.size()));
+            if (added) c.rowStudent.push_back(student);
+
+            recordCourse.push_back(course);
+            recordSession.push_back(session->second);
+            recordRow.push_back(row->second);
+        }
+
+        for (CourseBits& c : courseBits) {
+            c.words = (c.sessionDate.size() + 63) / 64;
+            c.present.assign(c.rowStudent.size() * c.words, 0);
+            c.recorded.assign(c.rowStudent.size() * c.words, 0);
+        }
+        for (size_t i = 0; i < records.size(); i++) {
+            CourseBits& c = courseBits[recordCourse[i]];
+            size_t word = recordRow[i] * c.words + recordSession[i] / 64;
+            uint64_t bit = uint64_t(1) << (recordSession[i] % 64);
+            c.recorded[word] |= bit;
+            if (records[i].status == "1") c.present[word] |= bit;
+        }
+        builtFrom = store.version();
+        built = true;
+    }
+
+public:
+    static const AttendanceBitmaps& current() {
+        static AttendanceBitmaps bitmaps;
+        const AttendanceStore& store = AttendanceStore::instance();
+        if (!bitmaps.built || bitmaps.builtFrom != store.version()) bitmaps.build(store);
+        return bitmaps;
+    }
+
+    const vector<string>& courseNames() const { return courses; }
+
+    // Calls visit(date, present) for each session of the course the student was marked in.
+    template <typename Visitor>
+    Rate forStudent(const string& student, const string& course, Visitor visit) const {
+        auto s = studentIds.find(student);
+        auto c = courseIds.find(course);
+        if (s == studentIds.end() || c == courseIds.end()) return Rate();
+        const CourseBits& bits = courseBits[c->second];
+        auto row = bits.rowOf.find(s->second);
+        if (row == bits.rowOf.end()) return Rate();
+
+        const uint64_t* p = &bits.present[row->second * bits.words];
+        const uint64_t* r = &bits.recorded[row->second * bits.words];
+        for (size_t w = 0; w < bits.words; w++) {
+            for (uint64_t set = r[w]; set; set &= set - 1) {
+                int bit = lowestBit(set);
+                visit(dates[bits.sessionDate[w * 64 + bit]], (p[w] >> bit) & 1);
+            }
+        }
+        return bits.rate(row->second);
+    }
+
+    // Every (student, course) pair whose attendance is below the threshold.
+    vector<Alert> below(double thresholdPercent) const {
+        vector<Alert> alerts;
+        for (uint32_t course = 0; course < courseBits.size(); course++) {
+            const CourseBits& bits = courseBits[course];
+            for (uint32_t row = 0; row < bits.rowStudent.size(); row++) {
+                Rate rate = bits.rate(row);
+                if (rate.percent() < thresholdPercent) {
+                    alerts.push_back({&students[bits.rowStudent[row]], &courses[course], rate});
+                }
+            }
+        }
+        return alerts;
+    }
+};
+
+// Announcements are stored once in announcements.csv as
+// sender,target,timestamp,content where target is "all" or a role, and
+// merged into each inbox when it is read. announcement_cursors.csv logs
+// how many announcements each user has seen (last line wins).
+struct Announcement {
+    string sender, target, timestamp, content;
+};
+
+vector<Announcement> loadAnnouncements() {
+    vector<Announcement> announcements;
+    forEachCSVRow("announcements.csv", [&](const vector<string_view>& a) {
+        if(a.size() < 4) return;
+        // Content is the last column and may itself contain commas.
+        string_view first = a[3];
+        string_view last = a.back();
+        string content(first.data(), last.data() + last.size() - first.data());
+        announcements.push_back({string(a[0]), string(a[1]), string(a[2]), content});
+    });
+    return announcements;
+}
+
+size_t announcementCursor(const string& user) {
+    size_t seen = 0;
+    forEachCSVRow("announcement_cursors.csv", [&](const vector<string_view>& c) {
+        if(c.size() >= 2 && c[0] == user) seen = strtoull(string(c[1]).c_str(), nullptr, 10);
+    });
+    return seen;
+}
+
+void saveAnnouncementCursor(const string& user, size_t seen) {
+    ofstream file("announcement_cursors.csv", ios::app);
+    file << user << "," << seen << "\n";
+}
+
 string getCurrentTimestamp() {
     time_t now = time(0);
     tm *ltm = localtime(&now);
@@ -85,24 +1049,7 @@ public:
 
 class Student : public User {
     float calculateCGPA() const {
-        auto grades = readCSV("grades.csv");
-        float totalPoints = 0;
-        int totalCredits = 0;
-        map<string, float> gradeScale = {
-            {"A+", 4.0}, {"A", 3.75}, {"B+", 3.5}, {"B", 3.0},
-            {"C+", 2.5}, {"C", 2.0}, {"D", 1.5}, {"F", 0.0}
-        };
-
-        for (const auto& grade : grades) {
-            if (grade.size() >= 4 && grade[0] == username) {
-                try {
-                    int credits = stoi(grade[3]);
-                    totalPoints += gradeScale[grade[2]] * credits;
-                    totalCredits += credits;
-                } catch (...) {}
-            }
-        }
-        return totalCredits > 0 ? totalPoints / totalCredits : 0.0f;
+        return GradesTable::instance().cgpa(username);
     }
 
 public:
@@ -114,6 +1061,17 @@ public:
 };
 
 class Faculty : public User {
+    vector<string> roster;
+    unordered_set<string> rosterIndex;
+
+    void loadRoster() {
+        roster.clear();
+        forEachCSVRow("users.csv", [&](const vector<string_view>& user) {
+            if(user.size() >= 3 && user[2] == "student") roster.emplace_back(user[0]);
+        });
+        rosterIndex = unordered_set<string>(roster.begin(), roster.end());
+    }
+
 public:
     Faculty(const string& uname) : User(uname, "faculty") {}
     void showDashboard() override;
@@ -130,6 +1088,7 @@ public:
     void manageUsers();
     void modifyGrades();
     void sendAnnouncement();
+    void attendanceAlerts();
 };
 
 void Student::showDashboard() {
@@ -161,43 +1120,44 @@ void Student::showDashboard() {
 
 void Student::viewGrades() const {
     clearScreen();
-    auto grades = readCSV("grades.csv");
+    const GradesTable& grades = GradesTable::instance();
     cout << "ACADEMIC REPORT\n";
-    cout << "CGPA: " << fixed << setprecision(2) << calculateCGPA() << "\n\n";
-
-    for (const auto& g : grades) {
-        if (g.size() >= 4 && g[0] == username) {
-            cout << g[1] << ": " << g[2]
-                 << " (" << g[3] << " credits)\n";
-        }
+    cout << "CGPA: " << fixed << setprecision(2) << grades.cgpa(username) << "\n\n";
+
+    auto [first, last] = grades.rowsFor(username);
+    for (uint32_t r = first; r < last; r++) {
+        cout << grades.courseName(r) << ": " << gradeName(grades.gradeAt(r)) << " (";
+        if (grades.creditsAt(r) >= 0) cout << grades.creditsAt(r);
+        else cout << "?";
+        cout << " credits)\n";
     }
-    pause();
+    pauseScreen();
 }
 
 void Student::viewAttendance() const {
     clearScreen();
-    auto attendance = readCSV("attendance.csv");
-    map<string, vector<pair<string, string>>> courseAttendance;
-
-    for (const auto& record : attendance) {
-        if(record.size() >= 4 && record[0] == username) {
-            string course = record[1];
-            string date = record[2];
-            string status = record[3] == "1" ? "Present" : "Absent";
-            courseAttendance[course].push_back({date, status});
-        }
-    }
+    const AttendanceBitmaps& attendance = AttendanceBitmaps::current();
+    vector<string> courses = attendance.courseNames();
+    sort(courses.begin(), courses.end());
 
     cout << "ATTENDANCE RECORD\n";
-    for(const auto& [course, records] : courseAttendance) {
-        cout << "\nCourse: " << course << "\n";
-        for(const auto& [date, status] : records) {
-            cout << date << ": " << status << "\n";
+    bool any = false;
+    for(const auto& course : courses) {
+        bool header = false;
+        auto rate = attendance.forStudent(username, course, [&](const string& date, bool present) {
+            if(!header) cout << "\nCourse: " << course << "\n";
+            header = true;
+            cout << date << ": " << (present ? "Present" : "Absent") << "\n";
+        });
+        if(rate.held) {
+            cout << "Attendance: " << fixed << setprecision(1) << rate.percent()
+                 << "% (" << rate.attended << "/" << rate.held << ")\n";
+            any = true;
         }
     }
 
-    if(courseAttendance.empty()) cout << "No attendance records found!\n";
-    pause();
+    if(!any) cout << "No attendance records found!\n";
+    pauseScreen();
 }
 
 void Faculty::showDashboard() {
@@ -234,6 +1194,7 @@ void Faculty::updateAttendance() {
     cin >> course;
     cout << "Enter Date (YYYY-MM-DD): ";
     cin >> date;
+    loadRoster();
 
     while(true) {
         clearScreen();
@@ -249,93 +1210,61 @@ void Faculty::updateAttendance() {
         if(choice == 1) manageStudentAttendance(course, date);
         else if(choice == 2) viewCurrentAttendance(course, date);  // Fixed this line
         else if(choice == 3) {
-            cout << "Attendance saved!\n";
-            pause();
+            if(AttendanceStore::instance().exportCSV()) cout << "Attendance saved!\n";
+            else cout << "Could not write attendance.csv, changes kept in attendance.log\n";
+            pauseScreen();
             return;
         }
         else {
             cout << "Invalid choice!\n";
-            pause();
+            pauseScreen();
         }
     }
 }
 
 
 void Faculty::manageStudentAttendance(const string& course, const string& date) {
-    auto users = readCSV("users.csv");
-    auto attendance = readCSV("attendance.csv");
-
     string student;
     cout << "Enter Student Username: ";
     cin >> student;
 
-    bool validStudent = false;
-    for(const auto& user : users) {
-        if(user.size() > 2 && user[0] == student && user[2] == "student") {
-            validStudent = true;
-            break;
-        }
-    }
-
-    if(!validStudent) {
+    if(!rosterIndex.count(student)) {
         cout << "Invalid student username!\n";
-        pause();
+        pauseScreen();
         return;
     }
 
-    vector<vector<string>> newAttendance;
-    for(const auto& record : attendance) {
-        if(!(record.size() > 3 && record[0] == student &&
-             record[1] == course && record[2] == date)) {
-            newAttendance.push_back(record);
-        }
-    }
-
     string status;
     cout << "Mark attendance for " << student << " (1=Present/0=Absent): ";
     cin >> status;
-    newAttendance.push_back({student, course, date, status});
 
-    writeCSV("attendance.csv", newAttendance);
-    cout << "Attendance updated for " << student << "!\n";
-    pause();
+    if(AttendanceStore::instance().upsert(student, course, date, status)) {
+        cout << "Attendance updated for " << student << "!\n";
+    } else {
+        cout << "Error saving attendance!\n";
+    }
+    pauseScreen();
 }
 
 void Faculty::viewCurrentAttendance(const string& course, const string& date) {
     clearScreen();
-
-    auto users = readCSV("users.csv");
-    vector<string> students;
-    for(const auto& user : users) {
-        if(user.size() >= 3 && user[2] == "student") {
-            students.push_back(user[0]);
-        }
-    }
-
-    auto attendance = readCSV("attendance.csv");
-    map<string, string> attendanceMap;
-
-    for(const auto& record : attendance) {
-        if(record.size() >= 4 && record[1] == course && record[2] == date) {
-            attendanceMap[record[0]] = record[3];
-        }
-    }
+    const AttendanceStore& store = AttendanceStore::instance();
 
     cout << "ATTENDANCE FOR " << course << " ON " << date << "\n\n";
     cout << "Student ID\t\tStatus\n";
     cout << "----------------------------------------\n";
 
-    for(const auto& student : students) {
+    for(const auto& student : roster) {
         cout << student << "\t\t";
-        if(attendanceMap.find(student) != attendanceMap.end()) {
-            cout << (attendanceMap[student] == "1" ? "Present" : "Absent");
+        if(const string* status = store.status(course, date, student)) {
+            cout << (*status == "1" ? "Present" : "Absent");
         } else {
             cout << "Not Recorded";
         }
         cout << "\n";
     }
 
-    pause();
+    pauseScreen();
 }
 
 void Faculty::manageGrades() {
@@ -350,23 +1279,23 @@ void Faculty::manageGrades() {
     cout << "Credits: ";
     cin >> credits;
 
-    auto grades = readCSV("grades.csv");
-    vector<vector<string>> newGrades;
-    bool updated = false;
-
-    for(auto& g : grades) {
-        if(g.size() >= 4 && g[0] == student && g[1] == course) {
-            g[2] = grade;
-            g[3] = credits;
-            updated = true;
+    // The student's row for the course, or a new one after their last.
+    GradesTable& table = GradesTable::instance();
+    auto [first, last] = table.rowsFor(student);
+    uint32_t row = last - first;
+    for (uint32_t r = first; r < last; r++) {
+        if (table.courseName(r) == course) {
+            row = r - first;
+            break;
         }
-        newGrades.push_back(g);
     }
-
-    if(!updated) newGrades.push_back({student, course, grade, credits});
-    writeCSV("grades.csv", newGrades);
-    cout << "Grade updated!\n";
-    pause();
+    if(uint64_t seq = GradeWal::instance().upsert(student, row, course, grade, credits)) {
+        table.upsert(student, row, course, grade, credits, seq);
+        cout << "Grade updated!\n";
+    } else {
+        cout << "Error saving grade!\n";
+    }
+    pauseScreen();
 }
 
 void Admin::showDashboard() {
@@ -379,7 +1308,8 @@ void Admin::showDashboard() {
              << "3. Send Announcement\n"
              << "4. Message Anyone\n"
              << "5. View Messages\n"
-             << "6. Logout\n"
+             << "6. Attendance Alerts\n"
+             << "7. Logout\n"
              << "Choice: ";
 
         if (!(cin >> choice)) {
@@ -394,8 +1324,9 @@ void Admin::showDashboard() {
             case 3: sendAnnouncement(); break;
             case 4: sendMessage(); break;
             case 5: viewMessages(); break;
+            case 6: attendanceAlerts(); break;
         }
-    } while(choice != 6);
+    } while(choice != 7);
 }
 
 void Admin::manageUsers() {
@@ -429,7 +1360,7 @@ void Admin::manageUsers() {
                 }
                 writeCSV("users.csv", newUsers);
                 cout << "User deleted!\n";
-                pause();
+                pauseScreen();
                 break;
             }
             case 3: {
@@ -437,7 +1368,7 @@ void Admin::manageUsers() {
                 for (const auto& u : users) {
                     if(u.size() >= 3) cout << u[0] << " - " << u[2] << "\n";
                 }
-                pause();
+                pauseScreen();
                 break;
             }
         }
@@ -450,23 +1381,21 @@ void Admin::modifyGrades() {
     cout << "Student Username: ";
     cin >> student;
 
-    auto grades = readCSV("grades.csv");
-    vector<vector<string>> studentGrades;
+    GradesTable& table = GradesTable::instance();
+    auto [first, last] = table.rowsFor(student);
 
     cout << "\nCurrent Grades:\n";
-    int index = 1;
-    for (const auto& grade : grades) {
-        if(grade.size() >= 4 && grade[0] == student) {
-            studentGrades.push_back(grade);
-            cout << index++ << ". " << grade[1]
-                 << " - " << grade[2]
-                 << " (" << grade[3] << " credits)\n";
-        }
+    for (uint32_t r = first; r < last; r++) {
+        cout << r - first + 1 << ". " << table.courseName(r)
+             << " - " << gradeName(table.gradeAt(r)) << " (";
+        if (table.creditsAt(r) >= 0) cout << table.creditsAt(r);
+        else cout << "?";
+        cout << " credits)\n";
     }
 
-    if(studentGrades.empty()) {
+    if(first == last) {
         cout << "No grades found!\n";
-        pause();
+        pauseScreen();
         return;
     }
 
@@ -474,9 +1403,9 @@ void Admin::modifyGrades() {
     cout << "\nSelect grade to modify (0 to cancel): ";
     cin >> choice;
 
-    if(choice < 1 || choice > studentGrades.size()) {
+    if(choice < 1 || choice > static_cast<int>(last - first)) {
         cout << "Modification cancelled.\n";
-        pause();
+        pauseScreen();
         return;
     }
 
@@ -486,38 +1415,63 @@ void Admin::modifyGrades() {
     cout << "New Credits: ";
     cin >> newCredits;
 
-    vector<vector<string>> newGrades;
-    for(auto& g : grades) {
-        if(g == studentGrades[choice-1]) {
-            g[2] = newGrade;
-            g[3] = newCredits;
-        }
-        newGrades.push_back(g);
+    uint32_t row = choice - 1;
+    string course = table.courseName(first + row);
+    if(uint64_t seq = GradeWal::instance().upsert(student, row, course, newGrade, newCredits)) {
+        table.upsert(student, row, course, newGrade, newCredits, seq);
+        cout << "Grade updated successfully!\n";
+    } else {
+        cout << "Error saving grade!\n";
+    }
+    pauseScreen();
+}
+
+void Admin::attendanceAlerts() {
+    clearScreen();
+    double threshold;
+    cout << "Minimum attendance % (e.g. 75): ";
+    if(!(cin >> threshold)) {
+        cin.clear();
+        threshold = 75;
     }
 
-    writeCSV("grades.csv", newGrades);
-    cout << "Grade updated successfully!\n";
-    pause();
+    auto start = chrono::steady_clock::now();
+    const AttendanceBitmaps& attendance = AttendanceBitmaps::current();
+    auto alerts = attendance.below(threshold);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    cout << "\nSTUDENTS BELOW " << threshold << "% ATTENDANCE\n";
+    cout << "----------------------------------------\n";
+    for(const auto& alert : alerts) {
+        cout << *alert.student << "\t" << *alert.course << "\t" << fixed << setprecision(1)
+             << alert.rate.percent() << "% (" << alert.rate.attended << "/" << alert.rate.held << ")\n";
+    }
+    cout << "\n" << alerts.size() << " flagged in " << setprecision(2) << ms << " ms\n";
+    pauseScreen();
 }
 
 void Admin::sendAnnouncement() {
     clearScreen();
-    string content;
+    string content, target;
+    cout << "Send to (all/student/faculty/admin): ";
+    cin >> target;
+    transform(target.begin(), target.end(), target.begin(), ::tolower);
+    if(target != "all" && target != "student" && target != "faculty" && target != "admin") {
+        cout << "Invalid audience!\n";
+        pauseScreen();
+        return;
+    }
+
     cout << "Announcement: ";
     cin.ignore();
     getline(cin, content);
 
-    auto users = readCSV("users.csv");
-    ofstream file("messages.csv", ios::app);
-    string timestamp = getCurrentTimestamp();
+    ofstream file("announcements.csv", ios::app);
+    file << username << "," << target << "," << getCurrentTimestamp() << "," << content << "\n";
 
-    for(const auto& user : users) {
-        if(user.size() >= 1) {
-            file << username << "," << user[0] << "," << content << "," << timestamp << "\n";
-        }
-    }
-    cout << "Announcement sent to all users!\n";
-    pause();
+    if(target == "all") cout << "Announcement sent to all users!\n";
+    else cout << "Announcement sent to all " << target << " users!\n";
+    pauseScreen();
 }
 
 User* User::login() {
@@ -537,7 +1491,7 @@ User* User::login() {
         }
     }
     cout << "Invalid credentials!\n";
-    pause();
+    pauseScreen();
     return nullptr;
 }
 
@@ -555,7 +1509,7 @@ void User::registerUser() {
 
     if(role != "student" && role != "faculty" && role != "admin") {
         cout << "Invalid role!\n";
-        pause();
+        pauseScreen();
         return;
     }
 
@@ -563,7 +1517,7 @@ void User::registerUser() {
     for(const auto& user : users) {
         if(user.size() >= 1 && user[0] == uname) {
             cout << "Username already exists!\n";
-            pause();
+            pauseScreen();
             return;
         }
     }
@@ -571,7 +1525,7 @@ void User::registerUser() {
     ofstream file("users.csv", ios::app);
     file << uname << "," << pwd << "," << role << "\n";
     cout << "Registration successful!\n";
-    pause();
+    pauseScreen();
 }
 
 void User::sendMessage() const {
@@ -596,7 +1550,7 @@ void User::sendMessage() const {
 
     if(!valid) {
         cout << "Invalid recipient for your role!\n";
-        pause();
+        pauseScreen();
         return;
     }
 
@@ -607,38 +1561,64 @@ void User::sendMessage() const {
     ofstream file("messages.csv", ios::app);
     file << username << "," << receiver << "," << content << "," << getCurrentTimestamp() << "\n";
     cout << "Message sent!\n";
-    pause();
+    pauseScreen();
 }
 
 void User::viewMessages() const {
     clearScreen();
-    auto messages = readCSV("messages.csv");
 
-    cout << "=== INBOX ===\n";
-    bool hasMessages = false;
-    for(const auto& msg : messages) {
-        if(msg.size() >= 4 && msg[1] == username) {
-            cout << "From: " << msg[0] << "\n"
-                 << "Time: " << msg[3] << "\n"
-                 << "Message: " << msg[2] << "\n\n";
-            hasMessages = true;
+    struct Entry {
+        string from, to, time, content;
+        bool broadcast, unread;
+    };
+    vector<Entry> inbox, sent;
+
+    forEachCSVRow("messages.csv", [&](const vector<string_view>& msg) {
+        if(msg.size() < 4) return;
+        if(msg[1] == username) inbox.push_back({string(msg[0]), "", string(msg[3]), string(msg[2]), false, false});
+        if(msg[0] == username) sent.push_back({"", string(msg[1]), string(msg[3]), string(msg[2]), false, false});
+    });
+
+    auto announcements = loadAnnouncements();
+    size_t seen = announcementCursor(username);
+    vector<Entry> broadcasts;
+    for(size_t i = 0; i < announcements.size(); i++) {
+        const auto& a = announcements[i];
+        if(a.target == "all" || a.target == role) {
+            broadcasts.push_back({a.sender, "", a.timestamp, a.content, true, i >= seen});
+        }
+        if(a.sender == username) {
+            sent.push_back({"", a.target == "all" ? "all users" : "all " + a.target + " users",
+                            a.timestamp, a.content, true, false});
         }
     }
-    if(!hasMessages) cout << "No received messages\n";
+
+    // Both lists are already in send order; merge them by timestamp.
+    vector<Entry> received;
+    received.reserve(inbox.size() + broadcasts.size());
+    merge(inbox.begin(), inbox.end(), broadcasts.begin(), broadcasts.end(), back_inserter(received),
+          [](const Entry& a, const Entry& b) { return a.time < b.time; });
+    stable_sort(sent.begin(), sent.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+
+    cout << "=== INBOX ===\n";
+    for(const auto& msg : received) {
+        cout << "From: " << msg.from << (msg.broadcast ? " [Announcement]" : "")
+             << (msg.unread ? " (new)" : "") << "\n"
+             << "Time: " << msg.time << "\n"
+             << "Message: " << msg.content << "\n\n";
+    }
+    if(received.empty()) cout << "No received messages\n";
 
     cout << "\n=== SENT MESSAGES ===\n";
-    hasMessages = false;
-    for(const auto& msg : messages) {
-        if(msg.size() >= 4 && msg[0] == username) {
-            cout << "To: " << msg[1] << "\n"
-                 << "Time: " << msg[3] << "\n"
-                 << "Message: " << msg[2] << "\n\n";
-            hasMessages = true;
-        }
+    for(const auto& msg : sent) {
+        cout << "To: " << msg.to << "\n"
+             << "Time: " << msg.time << "\n"
+             << "Message: " << msg.content << "\n\n";
     }
-    if(!hasMessages) cout << "No sent messages\n";
+    if(sent.empty()) cout << "No sent messages\n";
 
-    pause();
+    if(announcements.size() > seen) saveAnnouncementCursor(username, announcements.size());
+    pauseScreen();
 }
 
 class IUBATChatbot {
@@ -647,7 +1627,7 @@ public:
         clearScreen();
         cout << "Welcome to IUBAT Chatbot!\n";
         cout << "I'm here to help you with information about International University of Business Agriculture and Technology.\n";
-        pause();
+        pauseScreen();
 
         int choice;
         while(true) {
@@ -678,11 +1658,11 @@ public:
                 case 6: showContacts(); break;
                 case 7:
                     cout << "Thank you for using the chatbot!\n";
-                    pause();
+                    pauseScreen();
                     return;
                 default:
                     cout << "Invalid choice!\n";
-                    pause();
+                    pauseScreen();
             }
         }
     }
@@ -694,7 +1674,7 @@ private:
              << "- Established in 1991\n"
              << "- First private university in Bangladesh\n"
              << "- Offers international standard education\n";
-        pause();
+        pauseScreen();
     }
 
     void showPrograms() {
@@ -703,7 +1683,7 @@ private:
              << "1. Undergraduate Programs\n"
              << "2. Graduate Programs\n"
              << "3. Diploma Programs\n";
-        pause();
+        pauseScreen();
     }
 
     void showAdmissions() {
@@ -712,7 +1692,7 @@ private:
              << "- Completed application form\n"
              << "- Academic transcripts\n"
              << "- Entrance exam (if applicable)\n";
-        pause();
+        pauseScreen();
     }
 
     void showScholarships() {
@@ -721,7 +1701,7 @@ private:
              << "- Merit-based scholarships\n"
              << "- Need-based financial aid\n"
              << "- Special scholarships for women\n";
-        pause();
+        pauseScreen();
     }
 
     void showFacilities() {
@@ -731,7 +1711,7 @@ private:
              << "- Computer labs\n"
              << "- Library resources\n"
              << "- Sports facilities\n";
-        pause();
+        pauseScreen();
     }
 
     void showContacts() {
@@ -740,11 +1720,12 @@ private:
              << "Address: 4 Embankment Drive Road, Uttara, Dhaka\n"
              << "Phone: +88 02 55091801\n"
              << "Email: info@iubat.edu\n";
-        pause();
+        pauseScreen();
     }
 };
 
 int main() {
+    GradeWal::instance();  // replays grades.wal if the last run stopped before a checkpoint
     User* currentUser = nullptr;
     IUBATChatbot chatbot;
 
@@ -780,7 +1761,7 @@ int main() {
                 return 0;
             default:
                 cout << "Invalid choice!\n";
-                pause();
+                pauseScreen();
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,121 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Minimal benchmark harness shared by the bench_*.cpp programs.
+// Include it from exactly one translation unit per program: it replaces
+// the global operator new/delete to count allocations and live bytes.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string>
+
+namespace bench {
+    inline std::atomic<std::size_t> allocatedBytes{0};
+    inline std::atomic<std::size_t> allocationCount{0};
+    inline std::atomic<std::size_t> liveBytes{0};        // allocated and not yet freed
+    inline std::atomic<std::size_t> liveAllocations{0};
+    inline double minSeconds = 0.3;
+
+    struct Result {
+        std::size_t iterations;
+        double nsPerOp;
+        double bytesPerOp;
+        double allocsPerOp;
+        double rowsPerSecond;
+    };
+
+    inline void header() {
+        std::printf("%-40s %10s %14s %14s %10s %14s\n",
+                    "benchmark", "iters", "ns/op", "bytes/op", "allocs/op", "rows/s");
+    }
+
+    // Runs op() until minSeconds have passed; rows is how many records one
+    // op processes, used for the throughput column.
+    template <typename Op>
+    Result run(const std::string& name, std::size_t rows, Op op) {
+        using Clock = std::chrono::steady_clock;
+        op();  // warm caches and lazily loaded state
+
+        std::size_t iterations = 0;
+        std::size_t bytes0 = allocatedBytes, allocs0 = allocationCount;
+        auto start = Clock::now();
+        double elapsed = 0;
+        do {
+            op();
+            iterations++;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < minSeconds);
+
+        Result r;
+        r.iterations = iterations;
+        r.nsPerOp = elapsed * 1e9 / iterations;
+        r.bytesPerOp = double(allocatedBytes - bytes0) / iterations;
+        r.allocsPerOp = double(allocationCount - allocs0) / iterations;
+        r.rowsPerSecond = rows * iterations / elapsed;
+        std::printf("%-40s %10zu %14.0f %14.0f %10.1f %14.0f\n", name.c_str(), r.iterations,
+                    r.nsPerOp, r.bytesPerOp, r.allocsPerOp, r.rowsPerSecond);
+        return r;
+    }
+
+    // Fresh scratch directory as the working directory; the programs under
+    // test use relative file names.
+    inline std::filesystem::path enterScratch(const std::string& name) {
+        auto dir = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        std::filesystem::current_path(dir);
+        return dir;
+    }
+
+    inline void leaveScratch(const std::filesystem::path& dir) {
+        std::filesystem::current_path(dir.parent_path());
+        std::filesystem::remove_all(dir);
+    }
+
+    // Stops the optimizer from discarding a result.
+    inline volatile std::size_t sink;
+    inline void keep(std::size_t value) { sink = value; }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#endif
+
+// Each block carries its size in a header so delete can keep liveBytes
+// exact; the header keeps the default new alignment.
+namespace bench {
+    constexpr std::size_t blockHeader = alignof(std::max_align_t);
+}
+
+void* operator new(std::size_t size) {
+    bench::allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    bench::allocationCount.fetch_add(1, std::memory_order_relaxed);
+    bench::liveBytes.fetch_add(size, std::memory_order_relaxed);
+    bench::liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (char* p = static_cast<char*>(std::malloc(size + bench::blockHeader))) {
+        *reinterpret_cast<std::size_t*>(p) = size;
+        return p + bench::blockHeader;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    char* block = static_cast<char*>(p) - bench::blockHeader;
+    bench::liveBytes.fetch_sub(*reinterpret_cast<std::size_t*>(block), std::memory_order_relaxed);
+    bench::liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+    std::free(block);
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, std::size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { operator delete(p); }
+
+#endif
@@ -0,0 +1,93 @@
+#include "bench.h"
+#include "../CGPA CALCULATION BY MHR/grades.h"
+#include "../CGPA CALCULATION BY MHR/cgpa.h"
+#include "../CGPA CALCULATION BY MHR/filemanager.h"
+#include "../CGPA CALCULATION BY MHR/gradelog.h"
+#include <fstream>
+#include <random>
+#include <thread>
+#include <vector>
+
+// loadCourses, calculateGrade and calculateCGPA from the CGPA module, and
+// durable grade writes: one saveCourses rewrite per change against the
+// grade log, where concurrent writers share fsyncs.
+
+std::vector<Course> randomCourses(std::mt19937& rng) {
+    std::vector<Course> courses;
+    for (int i = 0; i < 100; i++) {
+        int marks = rng() % 101;
+        courses.push_back({"Course " + std::to_string(i), marks, 1 + static_cast<int>(rng() % 4), calculateGrade(marks)});
+    }
+    return courses;
+}
+
+int main() {
+    auto dir = bench::enterScratch("ums_bench_cgpa");
+    std::mt19937 rng(1);
+    bench::header();
+
+    for (std::size_t rows : {10, 100, 1000, 10000}) {
+        std::string user = "student" + std::to_string(rows);
+        std::vector<Course> courses;
+        {
+            std::ofstream out(user + ".csv");
+            for (std::size_t i = 0; i < rows; i++) {
+                int marks = rng() % 101;
+                int credit = 1 + rng() % 4;
+                Grade grade = calculateGrade(marks);
+                out << "Course " << i << "," << marks << "," << credit << "," << gradeName(grade) << "\n";
+                courses.push_back({"Course " + std::to_string(i), marks, credit, grade});
+            }
+        }
+
+        bench::run("loadCourses/" + std::to_string(rows), rows, [&] {
+            bench::keep(loadCourses(user).size());
+        });
+        bench::run("calculateCGPA/" + std::to_string(rows), rows, [&] {
+            bench::keep(static_cast<std::size_t>(calculateCGPA(courses) * 100));
+        });
+    }
+
+    std::vector<int> marks(100000);
+    for (auto& m : marks) m = rng() % 101;
+    bench::run("calculateGrade/100000", marks.size(), [&] {
+        std::size_t sum = 0;
+        for (int m : marks) sum += static_cast<std::size_t>(calculateGrade(m));
+        bench::keep(sum);
+    });
+    const GradeScale& scale = gradeScale();
+    bench::run("GradeScale::gradeFor/100000", marks.size(), [&] {
+        std::size_t sum = 0;
+        for (int m : marks) sum += static_cast<std::size_t>(scale.gradeFor(m));
+        bench::keep(sum);
+    });
+
+    std::vector<Course> hundred(randomCourses(rng));
+    bench::run("saveCourses/100", 1, [&] {
+        hundred[0].marks = (hundred[0].marks + 1) % 101;
+        bench::keep(saveCourses("rewritten", hundred));
+    });
+
+    GradeLog& log = gradeLog();
+    for (unsigned threads : {1u, 8u}) {
+        const std::size_t perThread = 32;
+        GradeLogStats before = log.stats();
+        bench::run("GradeLog::setRow/" + std::to_string(threads) + "threads", threads * perThread, [&] {
+            std::vector<std::thread> writers;
+            for (unsigned t = 0; t < threads; t++) {
+                writers.emplace_back([&, t] {
+                    std::string student = "logged" + std::to_string(t);
+                    for (std::size_t i = 0; i < perThread; i++) log.setRow(student, i, hundred[i]);
+                });
+            }
+            for (auto& w : writers) w.join();
+        });
+        GradeLogStats after = log.stats();
+        std::printf("  %.1f records per fsync\n",
+                    double(after.records - before.records) / double(after.syncs - before.syncs));
+    }
+    log.checkpoint();
+
+    bench::leaveScratch(dir);
+    return 0;
+}
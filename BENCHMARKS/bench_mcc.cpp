@@ -0,0 +1,75 @@
+#include "bench.h"
+#define main mcc_main
+#include "../FINAL FEATURES BY MHR/mcc.cpp"
+#undef main
+
+#include <random>
+
+// SystemManager startup loads and inbox lookup from FINAL FEATURES.
+
+int main() {
+    auto dir = bench::enterScratch("ums_bench_mcc");
+    mt19937 rng(3);
+    const char* roles[] = {"student", "faculty", "admin"};
+    bench::header();
+
+    for (size_t rows : {1000, 10000, 100000}) {
+        size_t userCount = max<size_t>(rows / 10, 10);
+        {
+            ofstream users("users.csv");
+            for (size_t i = 0; i < userCount; i++) users << "user" << i << ",pw" << i << "," << roles[i % 3] << "\n";
+            ofstream messages("messages.txt");
+            for (size_t i = 0; i < rows; i++) {
+                messages << "user" << rng() % userCount << "|user" << rng() % userCount
+                         << "|message body number " << i << "|" << 1700000000 + i << "\n";
+            }
+        }
+        string suffix = "/" + to_string(rows);
+
+        bench::run("loadUsersFromFile/" + to_string(userCount), userCount, [&] {
+            SystemManager sys;
+            sys.loadUsersFromFile();
+        });
+        bench::run("loadMessagesFromFile" + suffix, rows, [&] {
+            SystemManager sys;
+            sys.loadMessagesFromFile();
+        });
+
+        SystemManager sys;
+        sys.loadUsersFromFile();
+        sys.loadMessagesFromFile();
+        size_t next = 0;
+        bench::run("viewInbox lookup" + suffix, rows / userCount, [&] {
+            string user = "user" + to_string(next++ % userCount);
+            size_t bytes = 0;
+            for (size_t i : sys.inboxFor(user)) bytes += sys.messageAt(i).getContent().size();
+            bench::keep(bytes);
+        });
+    }
+
+    // Account storage on its own, at a million accounts.
+    {
+        const size_t userCount = 1000000;
+        {
+            ofstream users("users.csv");
+            for (size_t i = 0; i < userCount; i++) users << "user" << i << ",pw" << i << "," << roles[i % 3] << "\n";
+        }
+        bench::run("loadUsersFromFile/1000000", userCount, [&] {
+            SystemManager sys;
+            sys.loadUsersFromFile();
+        });
+
+        SystemManager sys;
+        sys.loadUsersFromFile();
+        vector<string> probes;
+        for (size_t i = 0; i < 4096; i++) probes.push_back("user" + to_string(rng() % (userCount * 2)));
+        bench::run("isStudent lookup/1000000", probes.size(), [&] {
+            size_t students = 0;
+            for (const string& name : probes) students += sys.isStudent(name);
+            bench::keep(students);
+        });
+    }
+
+    bench::leaveScratch(dir);
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "bench.h"
+#include "../ONE WAY MESSAGING BY MHR/sysm.h"
+
+#include <random>
+
+// Heap held by a loaded message store: the previous layout (three
+// std::strings per message, inbox keyed by receiver name) against
+// SystemManager's interned names and body arena. Then the cost of one
+// inbox page for an ordinary user and for "admin", who receives every tenth
+// message, against walking admin's whole inbox as viewInbox used to.
+// Usage: bench_msgmem [messages] (default 10000000)
+
+namespace {
+    struct LegacyMessage {
+        std::string sender, receiver, content;
+        std::time_t timestamp;
+    };
+
+    struct Measurement {
+        std::size_t bytes;
+        std::size_t allocations;
+        double seconds;
+    };
+
+    template <typename Load>
+    Measurement measure(Load load) {
+        std::size_t bytes0 = bench::liveBytes, allocs0 = bench::liveAllocations;
+        auto start = std::chrono::steady_clock::now();
+        load();
+        return {bench::liveBytes - bytes0, bench::liveAllocations - allocs0,
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+    }
+
+    void report(const char* layout, std::size_t count, const Measurement& m) {
+        std::printf("%-12s %12zu %12.1f %12.1f %14zu %10.2f\n", layout, count, m.bytes / 1048576.0,
+                    double(m.bytes) / count, m.allocations, m.seconds);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = argc > 1 ? std::stoull(argv[1]) : 10000000;
+    const std::size_t userCount = 20000;
+    auto dir = bench::enterScratch("ums_bench_msgmem");
+
+    {
+        std::vector<std::string> usernames;
+        for (std::size_t i = 0; i < userCount; i++) usernames.push_back("student" + std::to_string(i));
+        const std::string admin = "admin";
+        std::mt19937 rng(19);
+        std::string content;
+        MessageLog log("messages.log");
+        log.rewrite(count, [&](std::size_t i) {
+            content = "message body number " + std::to_string(i);
+            content.append(rng() % 40, 'x');
+            const std::string& receiver = i % 10 == 0 ? admin : usernames[rng() % userCount];
+            return MessageView{usernames[rng() % userCount], receiver, content,
+                               static_cast<std::time_t>(1700000000 + i)};
+        });
+    }
+
+    std::printf("%-12s %12s %12s %12s %14s %10s\n", "layout", "messages", "heap MB", "bytes/msg",
+                "allocations", "load s");
+    {
+        std::vector<LegacyMessage> messages;
+        std::unordered_map<std::string, std::vector<std::size_t>> inbox;
+        Measurement m = measure([&] {
+            MessageLog("messages.log").replay([&](const MessageView& msg) {
+                messages.push_back({std::string(msg.getSender()), std::string(msg.getReceiver()),
+                                    std::string(msg.getContent()), msg.getTimestamp()});
+                inbox[messages.back().receiver].push_back(messages.size() - 1);
+            });
+        });
+        report("strings", messages.size(), m);
+    }
+    {
+        SystemManager sys;
+        Measurement m = measure([&] { sys.load(); });
+        report("interned", sys.messageCount(), m);
+
+        std::printf("\n");
+        bench::header();
+        const std::string user = "student0", admin = "admin";
+        std::size_t adminPages = (sys.inboxFor(admin).size() + SystemManager::inboxPageSize - 1) /
+                                 SystemManager::inboxPageSize;
+        auto page = [&](const std::string& name, std::size_t n) {
+            return [&sys, &name, n] {
+                std::size_t bytes = 0;
+                for (const MessageHeader& h : sys.inboxPage(name, n)) bytes += h.preview.size();
+                bench::keep(bytes);
+            };
+        };
+        bench::run("inboxPage/" + user + "/first", SystemManager::inboxPageSize, page(user, 0));
+        bench::run("inboxPage/admin/first", SystemManager::inboxPageSize, page(admin, 0));
+        bench::run("inboxPage/admin/last", SystemManager::inboxPageSize, page(admin, adminPages - 1));
+        bench::run("inbox walk/admin", sys.inboxFor(admin).size(), [&] {
+            std::size_t bytes = 0;
+            for (std::size_t i : sys.inboxFor(admin)) bytes += sys.messageAt(i).getContent().size();
+            bench::keep(bytes);
+        });
+    }
+
+    bench::leaveScratch(dir);
+}
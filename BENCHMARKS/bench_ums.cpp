@@ -0,0 +1,36 @@
+#include "bench.h"
+#define main ums_main
+#include "../ALL-IN-ONE/ums.cpp"
+#undef main
+
+#include <random>
+
+// readCSV / writeCSV / forEachCSVRow from ALL-IN-ONE on grades-shaped rows.
+
+int main() {
+    auto dir = bench::enterScratch("ums_bench_ums");
+    mt19937 rng(2);
+    const char* grades[] = {"A+", "A", "B+", "B", "C+", "C", "D", "F"};
+    bench::header();
+
+    for (size_t rows : {1000, 10000, 100000}) {
+        vector<vector<string>> table;
+        for (size_t i = 0; i < rows; i++) {
+            table.push_back({"student" + to_string(rng() % 5000), "CSE" + to_string(100 + rng() % 300),
+                             grades[rng() % 8], to_string(1 + rng() % 4)});
+        }
+        string file = "grades" + to_string(rows) + ".csv";
+        string suffix = "/" + to_string(rows);
+
+        bench::run("writeCSV" + suffix, rows, [&] { writeCSV(file, table); });
+        bench::run("readCSV" + suffix, rows, [&] { bench::keep(readCSV(file).size()); });
+        bench::run("forEachCSVRow" + suffix, rows, [&] {
+            size_t n = 0;
+            forEachCSVRow(file, [&](const vector<string_view>& f) { n += f.size(); });
+            bench::keep(n);
+        });
+    }
+
+    bench::leaveScratch(dir);
+    return 0;
+}
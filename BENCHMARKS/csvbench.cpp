@@ -0,0 +1,86 @@
+#define main ums_main
+#include "../ALL-IN-ONE/ums.cpp"
+#undef main
+
+#include <chrono>
+#include <filesystem>
+#include <random>
+
+// readCSV before/after and the streaming visitor on a large grades.csv.
+
+using Clock = chrono::steady_clock;
+
+static vector<vector<string>> legacyReadCSV(const string& filename) {
+    vector<vector<string>> data;
+    ifstream file(filename);
+    string line;
+
+    while (getline(file, line)) {
+        if(line.empty()) continue;
+        vector<string> row;
+        size_t pos = 0;
+        while ((pos = line.find(',')) != string::npos) {
+            row.push_back(line.substr(0, pos));
+            line.erase(0, pos + 1);
+        }
+        row.push_back(line);
+        data.push_back(row);
+    }
+    return data;
+}
+
+template <typename F>
+static double seconds(F f) {
+    auto start = Clock::now();
+    f();
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void report(const char* name, double secs, size_t rows, double mb) {
+    cout << left << setw(28) << name << fixed << setprecision(3) << setw(8) << secs << "s  "
+         << setprecision(0) << setw(10) << rows / secs << " rows/s  "
+         << setprecision(1) << mb / secs << " MB/s\n";
+}
+
+int main(int argc, char** argv) {
+    size_t targetMB = argc > 1 ? strtoull(argv[1], nullptr, 10) : 100;
+
+    auto dir = filesystem::temp_directory_path() / "ums_csvbench";
+    filesystem::create_directories(dir);
+    string path = (dir / "grades.csv").string();
+
+    const char* grades[] = {"A+", "A", "B+", "B", "C+", "C", "D", "F"};
+    mt19937 rng(7);
+    size_t rows = 0;
+    {
+        ofstream out(path, ios::binary);
+        string buf;
+        size_t written = 0;
+        while (written < targetMB << 20) {
+            buf.clear();
+            for (int i = 0; i < 10000; i++, rows++) {
+                buf += "student" + to_string(rng() % 50000) + ",CSE" + to_string(100 + rng() % 300)
+                     + "," + grades[rng() % 8] + "," + to_string(1 + rng() % 4) + "\n";
+            }
+            out << buf;
+            written += buf.size();
+        }
+    }
+    double mb = filesystem::file_size(path) / 1048576.0;
+    cout << "file: " << setprecision(1) << fixed << mb << " MB, " << rows << " rows\n";
+
+    size_t n = 0;
+    report("legacy readCSV", seconds([&] { n += legacyReadCSV(path).size(); }), rows, mb);
+    report("mmap readCSV", seconds([&] { n += readCSV(path).size(); }), rows, mb);
+
+    size_t matches = 0;
+    report("forEachCSVRow filter", seconds([&] {
+        forEachCSVRow(path, [&](const vector<string_view>& f) {
+            if (f.size() >= 4 && f[0] == "student42") matches++;
+        });
+    }), rows, mb);
+
+    cout << "(checksum " << n << " / " << matches << ")\n";
+    filesystem::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,509 @@
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Synthetic datasets in the on-disk formats of all four programs.
+//
+//   datagen <cgpa|oneway|mcc|ums|all> <outdir> [--students N] [--faculty N]
+//           [--admins N] [--courses N] [--catalog N] [--messages N]
+//           [--days N] [--announcements N] [--seed N] [--threads N]
+//
+// Output is a pure function of the options and the seed: every file is cut
+// into fixed-size chunks, each chunk draws from its own generator seeded by
+// (seed, stream, chunk index), and chunks are written in order. The thread
+// count only changes how fast the bytes appear. Student i gets the same
+// courses and marks in every variant.
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+struct Config {
+    size_t students = 10000;
+    size_t faculty = 200;
+    size_t admins = 5;
+    size_t courses = 40;     // per student
+    size_t catalog = 400;    // distinct courses offered
+    size_t messages = 100000;
+    size_t days = 30;        // attendance days, and the span of message times
+    size_t announcements = 100;
+    uint64_t seed = 1;
+    unsigned threads = max(1u, thread::hardware_concurrency());
+
+    size_t users() const { return admins + faculty + students; }
+};
+
+enum Stream : uint64_t { Courses = 1, Messages, Attendance, Announcements };
+
+static uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+struct Rng {
+    uint64_t state;
+    Rng(uint64_t seed, Stream stream, uint64_t index) : state(mix(seed ^ mix((uint64_t(stream) << 56) ^ index))) {}
+    uint64_t next() { return mix(state += 0x9e3779b97f4a7c15ull); }
+    uint32_t below(uint32_t n) { return uint32_t((next() >> 32) * n >> 32); }
+};
+
+// ---- formatting -------------------------------------------------------------
+
+static void put(string& out, uint64_t v) {
+    char buf[24];
+    out.append(buf, to_chars(buf, buf + sizeof buf, v).ptr);
+}
+
+static void put2(string& out, unsigned v) {
+    out += char('0' + v / 10);
+    out += char('0' + v % 10);
+}
+
+// Users are numbered admins first, then faculty, then students.
+static void putUser(string& out, const Config& cfg, size_t u) {
+    if (u < cfg.admins) { out += "admin"; put(out, u); }
+    else if (u < cfg.admins + cfg.faculty) { out += "faculty"; put(out, u - cfg.admins); }
+    else { out += "student"; put(out, u - cfg.admins - cfg.faculty); }
+}
+
+static const char* roleOf(const Config& cfg, size_t u) {
+    return u < cfg.admins ? "admin" : u < cfg.admins + cfg.faculty ? "faculty" : "student";
+}
+
+static void putCourse(string& out, size_t c) {
+    static const char* dept[] = {"CSE", "EEE", "MAT", "PHY", "ENG"};
+    out += dept[c % 5];
+    put(out, 101 + c / 5);
+}
+
+static const int64_t epoch = 1704067200; // 2024-01-01 00:00:00 UTC
+
+// Days since 1970-01-01 to y-m-d (proleptic Gregorian, UTC).
+static void putDate(string& out, int64_t days) {
+    days += 719468;
+    int64_t era = days / 146097;
+    unsigned doe = unsigned(days - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    put(out, uint64_t(yoe + era * 400 + (m <= 2)));
+    out += '-'; put2(out, m);
+    out += '-'; put2(out, d);
+}
+
+static void putTimestamp(string& out, int64_t t) {
+    putDate(out, t / 86400);
+    unsigned s = unsigned(t % 86400);
+    out += ' '; put2(out, s / 3600);
+    out += ':'; put2(out, s / 60 % 60);
+    out += ':'; put2(out, s % 60);
+}
+
+static void putContent(string& out, Rng& rng) {
+    static const char* words[] = {
+        "please", "check", "the", "assignment", "deadline", "for", "next", "week", "lab", "report",
+        "grades", "are", "posted", "meeting", "room", "is", "changed", "exam", "schedule", "thanks",
+        "attendance", "submit", "project", "proposal", "before", "friday", "class", "cancelled", "today", "notes"};
+    unsigned n = 3 + rng.below(13);
+    for (unsigned i = 0; i < n; i++) {
+        if (i) out += ' ';
+        out += words[rng.below(sizeof words / sizeof *words)];
+    }
+}
+
+// ---- per-student academic record ---------------------------------------------
+
+struct Enrolment {
+    uint32_t course;
+    int marks;
+    int credit;
+};
+
+static void enrolments(const Config& cfg, size_t student, vector<Enrolment>& out) {
+    Rng rng(cfg.seed, Courses, student);
+    size_t n = min(cfg.courses, cfg.catalog);
+    uint32_t start = rng.below(uint32_t(cfg.catalog));
+    out.clear();
+    for (size_t j = 0; j < n; j++) {
+        int marks = 30 + int(rng.below(36) + rng.below(36));
+        out.push_back({uint32_t((start + j) % cfg.catalog), marks, 1 + int(rng.below(4))});
+    }
+}
+
+// Default scale of the CGPA module and FINAL FEATURES.
+static const char* letterGrade(int marks) {
+    static const int floor[] = {80, 75, 70, 65, 60, 55, 50, 45, 40, 0};
+    static const char* names[] = {"A+", "A", "A-", "B+", "B", "B-", "C+", "C", "D", "F"};
+    int i = 0;
+    while (marks < floor[i]) i++;
+    return names[i];
+}
+
+// ALL-IN-ONE only knows A+, A, B+, B, C+, C, D, F.
+static const char* umsGrade(int marks) {
+    static const int floor[] = {80, 75, 70, 65, 60, 55, 50, 0};
+    static const char* names[] = {"A+", "A", "B+", "B", "C+", "C", "D", "F"};
+    int i = 0;
+    while (marks < floor[i]) i++;
+    return names[i];
+}
+
+// Each course meets on two weekdays, staggered across the catalog.
+static bool meets(uint32_t course, size_t day) {
+    size_t w = (day + course) % 7;
+    return w == 0 || w == 3;
+}
+
+// ---- writers ---------------------------------------------------------------
+
+struct Output {
+    string name;
+    size_t bytes = 0;
+    size_t files = 0;
+};
+
+// Generates chunks on `threads` workers and writes them to `file` in chunk
+// order. At most `window` chunks are buffered, so memory stays bounded no
+// matter how large the file is.
+static Output writeOrdered(const filesystem::path& file, size_t chunks, unsigned threads,
+                           const function<void(size_t, string&)>& gen) {
+    Output result{file.filename().string()};
+    FILE* out = fopen(file.string().c_str(), "wb");
+    if (!out) {
+        cerr << "Cannot create " << file << "\n";
+        exit(1);
+    }
+
+    size_t window = size_t(threads) * 4;
+    vector<string> slots(window);
+    vector<char> ready(window, 0);
+    size_t claimed = 0, written = 0;
+    mutex m;
+    condition_variable cv;
+
+    auto worker = [&] {
+        string buf;
+        for (;;) {
+            size_t c;
+            {
+                unique_lock<mutex> lock(m);
+                cv.wait(lock, [&] { return claimed >= chunks || claimed < written + window; });
+                if (claimed >= chunks) return;
+                c = claimed++;
+            }
+            buf.clear();
+            gen(c, buf);
+            {
+                lock_guard<mutex> lock(m);
+                swap(slots[c % window], buf);
+                ready[c % window] = 1;
+            }
+            cv.notify_all();
+        }
+    };
+    vector<thread> pool;
+    for (unsigned t = 0; t < threads; t++) pool.emplace_back(worker);
+
+    string chunk;
+    for (size_t c = 0; c < chunks; c++) {
+        {
+            unique_lock<mutex> lock(m);
+            cv.wait(lock, [&] { return ready[c % window] != 0; });
+            swap(chunk, slots[c % window]);
+            ready[c % window] = 0;
+            written++;
+        }
+        cv.notify_all();
+        if (fwrite(chunk.data(), 1, chunk.size(), out) != chunk.size()) {
+            cerr << "Write failed: " << file << "\n";
+            exit(1);
+        }
+        result.bytes += chunk.size();
+    }
+    for (auto& t : pool) t.join();
+    fclose(out);
+    result.files = 1;
+    return result;
+}
+
+static size_t chunkCount(size_t items, size_t perChunk) { return (items + perChunk - 1) / perChunk; }
+
+static Output usersCSV(const Config& cfg, const filesystem::path& dir) {
+    const size_t per = 65536;
+    return writeOrdered(dir / "users.csv", chunkCount(cfg.users(), per), cfg.threads, [&](size_t c, string& out) {
+        for (size_t u = c * per; u < min(cfg.users(), (c + 1) * per); u++) {
+            putUser(out, cfg, u);
+            out += ",pw"; put(out, u);
+            out += ','; out += roleOf(cfg, u);
+            out += '\n';
+        }
+    });
+}
+
+// One <username>.csv per student (CGPA module and FINAL FEATURES).
+static Output studentFiles(const Config& cfg, const filesystem::path& dir) {
+    Output result{"<student>.csv"};
+    atomic<size_t> nextBlock{0}, bytes{0};
+    const size_t per = 256;
+    auto worker = [&] {
+        vector<Enrolment> rows;
+        string buf, path;
+        for (size_t b; (b = nextBlock++) * per < cfg.students;) {
+            for (size_t s = b * per; s < min(cfg.students, (b + 1) * per); s++) {
+                enrolments(cfg, s, rows);
+                buf.clear();
+                for (const auto& e : rows) {
+                    putCourse(buf, e.course);
+                    buf += ','; put(buf, uint64_t(e.marks));
+                    buf += ','; put(buf, uint64_t(e.credit));
+                    buf += ','; buf += letterGrade(e.marks);
+                    buf += '\n';
+                }
+                path = (dir / ("student" + to_string(s) + ".csv")).string();
+                FILE* f = fopen(path.c_str(), "wb");
+                if (!f || fwrite(buf.data(), 1, buf.size(), f) != buf.size()) {
+                    cerr << "Write failed: " << path << "\n";
+                    exit(1);
+                }
+                fclose(f);
+                bytes += buf.size();
+            }
+        }
+    };
+    vector<thread> pool;
+    for (unsigned t = 0; t < cfg.threads; t++) pool.emplace_back(worker);
+    for (auto& t : pool) t.join();
+    result.bytes = bytes;
+    result.files = cfg.students;
+    return result;
+}
+
+static Output gradesCSV(const Config& cfg, const filesystem::path& dir) {
+    const size_t per = 1024;
+    return writeOrdered(dir / "grades.csv", chunkCount(cfg.students, per), cfg.threads, [&](size_t c, string& out) {
+        vector<Enrolment> rows;
+        for (size_t s = c * per; s < min(cfg.students, (c + 1) * per); s++) {
+            enrolments(cfg, s, rows);
+            for (const auto& e : rows) {
+                out += "student"; put(out, s);
+                out += ','; putCourse(out, e.course);
+                out += ','; out += umsGrade(e.marks);
+                out += ','; put(out, uint64_t(e.credit));
+                out += '\n';
+            }
+        }
+    });
+}
+
+// Date-major, so the file looks like faculty taking attendance day by day.
+static Output attendanceCSV(const Config& cfg, const filesystem::path& dir) {
+    const size_t per = 1024;
+    size_t blocks = chunkCount(cfg.students, per);
+    return writeOrdered(dir / "attendance.csv", blocks * cfg.days, cfg.threads, [&](size_t c, string& out) {
+        size_t day = c / blocks, block = c % blocks;
+        string date;
+        putDate(date, epoch / 86400 + int64_t(day));
+        Rng rng(cfg.seed, Attendance, c);
+        vector<Enrolment> rows;
+        for (size_t s = block * per; s < min(cfg.students, (block + 1) * per); s++) {
+            enrolments(cfg, s, rows);
+            for (const auto& e : rows) {
+                if (!meets(e.course, day)) continue;
+                out += "student"; put(out, s);
+                out += ','; putCourse(out, e.course);
+                out += ','; out += date;
+                out += rng.below(100) < 85 ? ",1\n" : ",0\n";
+            }
+        }
+    });
+}
+
+struct SyntheticMessage {
+    size_t sender, receiver;
+    int64_t time;
+};
+
+static SyntheticMessage message(const Config& cfg, Rng& rng, size_t i) {
+    size_t n = cfg.users();
+    size_t s = rng.below(uint32_t(n));
+    size_t r = n > 1 ? (s + 1 + rng.below(uint32_t(n - 1))) % n : s;
+    uint64_t span = max<size_t>(cfg.days, 1) * 86400ull;
+    return {s, r, epoch + int64_t(span * i / max<size_t>(cfg.messages, 1))};
+}
+
+static const size_t messagesPerChunk = 65536;
+
+// FINAL FEATURES: sender|receiver|content|unix time
+static Output messagesTxt(const Config& cfg, const filesystem::path& dir) {
+    return writeOrdered(dir / "messages.txt", chunkCount(cfg.messages, messagesPerChunk), cfg.threads, [&](size_t c, string& out) {
+        Rng rng(cfg.seed, Messages, c);
+        for (size_t i = c * messagesPerChunk; i < min(cfg.messages, (c + 1) * messagesPerChunk); i++) {
+            auto m = message(cfg, rng, i);
+            putUser(out, cfg, m.sender); out += '|';
+            putUser(out, cfg, m.receiver); out += '|';
+            putContent(out, rng); out += '|';
+            put(out, uint64_t(m.time)); out += '\n';
+        }
+    });
+}
+
+// ALL-IN-ONE: sender,receiver,content,YYYY-MM-DD HH:MM:SS
+static Output messagesCSV(const Config& cfg, const filesystem::path& dir) {
+    return writeOrdered(dir / "messages.csv", chunkCount(cfg.messages, messagesPerChunk), cfg.threads, [&](size_t c, string& out) {
+        Rng rng(cfg.seed, Messages, c);
+        for (size_t i = c * messagesPerChunk; i < min(cfg.messages, (c + 1) * messagesPerChunk); i++) {
+            auto m = message(cfg, rng, i);
+            putUser(out, cfg, m.sender); out += ',';
+            putUser(out, cfg, m.receiver); out += ',';
+            putContent(out, rng); out += ',';
+            putTimestamp(out, m.time); out += '\n';
+        }
+    });
+}
+
+// ONE WAY MESSAGING: framed records, same layout and checksum as msglog.h.
+static uint32_t fnv1a(const char* data, size_t size) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void put32(string& out, uint32_t v) { out.append(reinterpret_cast<const char*>(&v), sizeof v); }
+
+static Output messagesLog(const Config& cfg, const filesystem::path& dir) {
+    return writeOrdered(dir / "messages.log", chunkCount(cfg.messages, messagesPerChunk), cfg.threads, [&](size_t c, string& out) {
+        Rng rng(cfg.seed, Messages, c);
+        string s, r, body;
+        for (size_t i = c * messagesPerChunk; i < min(cfg.messages, (c + 1) * messagesPerChunk); i++) {
+            auto m = message(cfg, rng, i);
+            s.clear(); r.clear(); body.clear();
+            putUser(s, cfg, m.sender);
+            putUser(r, cfg, m.receiver);
+            putContent(body, rng);
+
+            size_t at = out.size();
+            uint32_t payload = uint32_t(sizeof m.time + 12 + s.size() + r.size() + body.size());
+            put32(out, payload);
+            put32(out, 0);
+            out.append(reinterpret_cast<const char*>(&m.time), sizeof m.time);
+            put32(out, uint32_t(s.size()));
+            put32(out, uint32_t(r.size()));
+            put32(out, uint32_t(body.size()));
+            out += s; out += r; out += body;
+            uint32_t sum = fnv1a(out.data() + at + 8, payload);
+            memcpy(&out[at + 4], &sum, sizeof sum);
+        }
+    });
+}
+
+// ALL-IN-ONE: sender,target,timestamp,content
+static Output announcementsCSV(const Config& cfg, const filesystem::path& dir) {
+    static const char* targets[] = {"all", "student", "faculty", "admin"};
+    return writeOrdered(dir / "announcements.csv", cfg.admins ? 1 : 0, 1, [&](size_t, string& out) {
+        Rng rng(cfg.seed, Announcements, 0);
+        uint64_t span = max<size_t>(cfg.days, 1) * 86400ull;
+        for (size_t i = 0; i < cfg.announcements; i++) {
+            putUser(out, cfg, rng.below(uint32_t(cfg.admins))); out += ',';
+            out += targets[rng.below(4)]; out += ',';
+            putTimestamp(out, epoch + int64_t(span * i / cfg.announcements)); out += ',';
+            putContent(out, rng); out += '\n';
+        }
+    });
+}
+
+// ---- driver ------------------------------------------------------------------
+
+static void report(const Output& o, double seconds) {
+    printf("  %-20s %10zu files %12.1f MB %8.2f s %8.1f MB/s\n", o.name.c_str(), o.files, o.bytes / 1e6, seconds,
+           seconds > 0 ? o.bytes / 1e6 / seconds : 0.0);
+}
+
+static size_t generate(const string& variant, const Config& cfg, const filesystem::path& dir) {
+    using Writer = Output (*)(const Config&, const filesystem::path&);
+    vector<Writer> writers;
+    if (variant == "cgpa") writers = {usersCSV, studentFiles};
+    else if (variant == "oneway") writers = {usersCSV, messagesLog};
+    else if (variant == "mcc") writers = {usersCSV, studentFiles, messagesTxt};
+    else if (variant == "ums") writers = {usersCSV, gradesCSV, attendanceCSV, messagesCSV, announcementsCSV};
+    else {
+        cerr << "Unknown variant: " << variant << "\n";
+        exit(1);
+    }
+
+    filesystem::create_directories(dir);
+    cout << variant << " -> " << dir.string() << "\n";
+    size_t total = 0;
+    for (Writer w : writers) {
+        auto start = Clock::now();
+        Output o = w(cfg, dir);
+        report(o, chrono::duration<double>(Clock::now() - start).count());
+        total += o.bytes;
+    }
+    return total;
+}
+
+static void usage() {
+    cerr << "Usage: datagen <cgpa|oneway|mcc|ums|all> <outdir> [--students N] [--faculty N] [--admins N]\n"
+            "               [--courses N] [--catalog N] [--messages N] [--days N] [--announcements N]\n"
+            "               [--seed N] [--threads N]\n";
+    exit(1);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) usage();
+    string variant = argv[1];
+    filesystem::path out = argv[2];
+
+    Config cfg;
+    for (int i = 3; i < argc; i++) {
+        string opt = argv[i];
+        if (i + 1 >= argc) usage();
+        uint64_t v = strtoull(argv[++i], nullptr, 10);
+        if (opt == "--students") cfg.students = v;
+        else if (opt == "--faculty") cfg.faculty = v;
+        else if (opt == "--admins") cfg.admins = v;
+        else if (opt == "--courses") cfg.courses = v;
+        else if (opt == "--catalog") cfg.catalog = max<uint64_t>(v, 1);
+        else if (opt == "--messages") cfg.messages = v;
+        else if (opt == "--days") cfg.days = v;
+        else if (opt == "--announcements") cfg.announcements = v;
+        else if (opt == "--seed") cfg.seed = v;
+        else if (opt == "--threads") cfg.threads = unsigned(max<uint64_t>(v, 1));
+        else usage();
+    }
+    if (cfg.users() < 1 || cfg.users() > UINT32_MAX) {
+        cerr << "User count must be between 1 and " << UINT32_MAX << "\n";
+        return 1;
+    }
+
+    auto start = Clock::now();
+    size_t bytes = 0;
+    if (variant == "all") {
+        for (const char* v : {"cgpa", "oneway", "mcc", "ums"}) bytes += generate(v, cfg, out / v);
+    } else {
+        bytes = generate(variant, cfg, out);
+    }
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+    printf("# bytes=%zu seconds=%.2f MB/s=%.1f threads=%u seed=%llu\n", bytes, seconds, bytes / 1e6 / seconds,
+           cfg.threads, static_cast<unsigned long long>(cfg.seed));
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "../CGPA CALCULATION BY MHR/grades.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+// Per-row grading cost of a bulk upload: the old path re-read grade_scale.csv
+// for every row, the compiled scale is an array index.
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static string legacyCalculateGrade(int marks) {
+    auto scale = loadGradeScale();
+    for (const auto& [grade, range] : scale) {
+        if (marks >= range.first && marks <= range.second) {
+            return grade;
+        }
+    }
+    return "F";
+}
+
+template <typename F>
+static double nsPerRow(const vector<int>& marks, F grade, size_t& checksum) {
+    auto start = Clock::now();
+    for (int m : marks) checksum += grade(m);
+    auto elapsed = chrono::duration<double, nano>(Clock::now() - start).count();
+    return elapsed / marks.size();
+}
+
+int main(int argc, char** argv) {
+    size_t rows = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+
+    auto dir = filesystem::temp_directory_path() / "ums_gradebench";
+    filesystem::create_directories(dir);
+    filesystem::current_path(dir);
+    ofstream("grade_scale.csv") << "A+,80,100\nA,75,79\nA-,70,74\nB+,65,69\nB,60,64\n"
+                                << "B-,55,59\nC+,50,54\nC,45,49\nD,40,44\nF,0,39\n";
+
+    mt19937 rng(42);
+    uniform_int_distribution<int> dist(0, 100);
+    vector<int> marks(rows);
+    for (auto& m : marks) m = dist(rng);
+
+    size_t checksum = 0;
+    double before = nsPerRow(marks, [](int m) { return legacyCalculateGrade(m).size(); }, checksum);
+    double perCall = nsPerRow(marks, [](int m) { return size_t(calculateGrade(m)); }, checksum);
+    const GradeScale& scale = gradeScale();
+    double hoisted = nsPerRow(marks, [&](int m) { return size_t(scale.gradeFor(m)); }, checksum);
+
+    cout << "rows: " << rows << "\n";
+    cout << "re-parse per row     : " << before << " ns/row\n";
+    cout << "calculateGrade       : " << perCall << " ns/row\n";
+    cout << "compiled table       : " << hoisted << " ns/row\n";
+    cout << "speedup              : " << before / hoisted << "x\n";
+    cout << "(checksum " << checksum << ")\n";
+
+    filesystem::current_path(filesystem::temp_directory_path());
+    filesystem::remove_all(dir);
+    return 0;
+}
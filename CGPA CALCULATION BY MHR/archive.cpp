@@ -0,0 +1,1082 @@
+#include "archive.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+// ZIP layout follows APPNOTE.TXT: local header + data per entry, then the
+// central directory and its end record. ZIP64 records are added only when
+// the entry count or an offset no longer fits the 16/32-bit fields.
+//
+// Compression is deflate (RFC 1951), one block per chunk. A file larger
+// than one chunk is split, and each chunk is compressed independently but
+// primed with the 32 KiB before it, so matches still reach back across the
+// split. Chunks other than the last end with an empty stored block, which
+// byte-aligns them so their outputs can simply be concatenated.
+
+namespace {
+    const std::size_t chunkSize = 1 << 20;
+    const std::size_t windowSize = 32768;
+    const std::size_t batchBytes = 16 << 20;  // input held in memory per batch
+    const std::size_t batchItems = 4096;
+    const int maxChain = 32;                  // hash chain steps per match search
+
+    const std::uint32_t localSignature = 0x04034b50;
+    const std::uint32_t descriptorSignature = 0x08074b50;
+    const std::uint32_t centralSignature = 0x02014b50;
+    const std::uint32_t zip64EndSignature = 0x06064b50;
+    const std::uint32_t zip64LocatorSignature = 0x07064b50;
+    const std::uint32_t endSignature = 0x06054b50;
+
+    const unsigned short lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                           35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    const unsigned char lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                           3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    const unsigned short distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257,
+                                             385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193,
+                                             12289, 16385, 24577};
+    const unsigned char distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                             6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    unsigned reverseBits(unsigned code, int bits) {
+        unsigned out = 0;
+        for (int i = 0; i < bits; i++) {
+            out = (out << 1) | (code & 1);
+            code >>= 1;
+        }
+        return out;
+    }
+
+    // CRC-32 tables plus the fixed Huffman codes (bit-reversed, since deflate
+    // packs bits from the least significant end) and symbol lookups.
+    struct Tables {
+        std::uint32_t crc[256];
+        unsigned short literalCode[288];
+        unsigned char literalBits[288];
+        unsigned short distanceCode[30];
+        unsigned char lengthSymbol[259];
+        unsigned char distanceSymbol[512];  // by distance-1 below 256, else 256 + ((distance-1) >> 7)
+
+        Tables() {
+            for (std::uint32_t i = 0; i < 256; i++) {
+                std::uint32_t c = i;
+                for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                crc[i] = c;
+            }
+            for (int i = 0; i < 288; i++) {
+                unsigned code;
+                int bits;
+                if (i < 144) code = 0x30 + i, bits = 8;
+                else if (i < 256) code = 0x190 + (i - 144), bits = 9;
+                else if (i < 280) code = i - 256, bits = 7;
+                else code = 0xC0 + (i - 280), bits = 8;
+                literalCode[i] = static_cast<unsigned short>(reverseBits(code, bits));
+                literalBits[i] = static_cast<unsigned char>(bits);
+            }
+            for (int i = 0; i < 30; i++) distanceCode[i] = static_cast<unsigned short>(reverseBits(i, 5));
+            for (int s = 0; s < 29; s++) {
+                for (int len = lengthBase[s]; len < lengthBase[s] + (1 << lengthExtra[s]) && len <= 258; len++) {
+                    lengthSymbol[len] = static_cast<unsigned char>(s);
+                }
+            }
+            lengthSymbol[258] = 28;
+            for (int s = 0; s < 30; s++) {
+                for (int d = distanceBase[s]; d < distanceBase[s] + (1 << distanceExtra[s]); d++) {
+                    if (d <= 256) distanceSymbol[d - 1] = static_cast<unsigned char>(s);
+                    else distanceSymbol[256 + ((d - 1) >> 7)] = static_cast<unsigned char>(s);
+                }
+            }
+        }
+    };
+
+    const Tables& tables() {
+        static const Tables t;
+        return t;
+    }
+
+    std::uint32_t crc32(std::uint32_t crc, const unsigned char* data, std::size_t size) {
+        const std::uint32_t* table = tables().crc;
+        crc = ~crc;
+        for (std::size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    class BitWriter {
+    public:
+        explicit BitWriter(std::string& out) : out(out) {}
+
+        void put(std::uint32_t value, int count) {
+            bits |= static_cast<std::uint64_t>(value) << used;
+            used += count;
+            while (used >= 8) {
+                out += static_cast<char>(bits & 0xFF);
+                bits >>= 8;
+                used -= 8;
+            }
+        }
+
+        void align() {
+            if (used > 0) out += static_cast<char>(bits & 0xFF);
+            bits = 0;
+            used = 0;
+        }
+
+    private:
+        std::string& out;
+        std::uint64_t bits = 0;
+        int used = 0;
+    };
+
+    // Huffman code lengths for freq[0, n), no longer than maxBits. At least
+    // two symbols always get a code, so every code is complete.
+    void buildLengths(std::uint32_t* freq, int n, int maxBits, unsigned char* lengths) {
+        std::fill(lengths, lengths + n, 0);
+        std::vector<int> used;
+        for (int s = 0; s < n; s++) {
+            if (freq[s]) used.push_back(s);
+        }
+        for (int s = 0; used.size() < 2; s++) {
+            if (!freq[s]) {
+                freq[s] = 1;
+                used.push_back(s);
+            }
+        }
+        std::sort(used.begin(), used.end(), [&](int a, int b) { return freq[a] != freq[b] ? freq[a] < freq[b] : a < b; });
+
+        // Two-queue Huffman construction over the sorted leaves; nodes at
+        // index >= m are internal, children recorded in parent[].
+        std::size_t m = used.size();
+        std::vector<std::uint64_t> weight(2 * m - 1);
+        std::vector<std::size_t> parent(2 * m - 1, 0);
+        for (std::size_t i = 0; i < m; i++) weight[i] = freq[used[i]];
+        std::size_t leaf = 0, inner = m;
+        for (std::size_t next = m; next < 2 * m - 1; next++) {
+            std::size_t pick[2];
+            for (std::size_t& p : pick) {
+                if (leaf < m && (inner >= next || weight[leaf] <= weight[inner])) p = leaf++;
+                else p = inner++;
+            }
+            weight[next] = weight[pick[0]] + weight[pick[1]];
+            parent[pick[0]] = parent[pick[1]] = next;
+        }
+        std::vector<int> depth(2 * m - 1, 0);
+        int count[64] = {0};
+        for (std::size_t i = 2 * m - 1; i-- > 0;) {
+            if (i != 2 * m - 2) depth[i] = depth[parent[i]] + 1;
+            if (i < m) count[std::min(depth[i], 63)]++;
+        }
+
+        // Fold over-long codes back under maxBits, keeping the code complete.
+        for (int len = maxBits + 1; len < 64; len++) {
+            count[maxBits] += count[len];
+            count[len] = 0;
+        }
+        std::uint64_t total = 0;
+        for (int len = 1; len <= maxBits; len++) total += std::uint64_t(count[len]) << (maxBits - len);
+        while (total != (std::uint64_t(1) << maxBits)) {
+            count[maxBits]--;
+            for (int len = maxBits - 1; len > 0; len--) {
+                if (count[len]) {
+                    count[len]--;
+                    count[len + 1] += 2;
+                    break;
+                }
+            }
+            total--;
+        }
+
+        // Most frequent symbols take the shortest codes.
+        std::size_t i = m;
+        for (int len = 1; len <= maxBits; len++) {
+            for (int k = 0; k < count[len]; k++) lengths[used[--i]] = static_cast<unsigned char>(len);
+        }
+    }
+
+    // Bit-reversed canonical codes for the given lengths.
+    void assignCodes(const unsigned char* lengths, int n, unsigned short* codes) {
+        int perLength[16] = {0};
+        for (int s = 0; s < n; s++) perLength[lengths[s]]++;
+        perLength[0] = 0;
+        unsigned next[16] = {0};
+        unsigned code = 0;
+        for (int len = 1; len < 16; len++) {
+            code = (code + perLength[len - 1]) << 1;
+            next[len] = code;
+        }
+        for (int s = 0; s < n; s++) {
+            if (lengths[s]) codes[s] = static_cast<unsigned short>(reverseBits(next[lengths[s]]++, lengths[s]));
+        }
+    }
+
+    // A literal (distance 0, byte in length) or a back-reference.
+    struct Token {
+        std::uint16_t length;
+        std::uint16_t distance;
+    };
+
+    // Compresses buf[start, end) as one deflate block; buf[0, start) is
+    // earlier file content that matches may refer back to. The block uses
+    // whichever of the fixed or a per-chunk dynamic Huffman code is shorter.
+    void deflateChunk(const unsigned char* buf, std::size_t start, std::size_t end, bool last, std::string& out) {
+        const Tables& t = tables();
+        // Per-thread search state, reused across chunks. The hash table is
+        // sized to the input so small files do not pay for clearing 32K heads.
+        thread_local std::vector<std::int32_t> head, prev;
+        thread_local std::vector<Token> tokens;
+        int hashBits = 9;
+        while (hashBits < 15 && (std::size_t(1) << hashBits) < end) hashBits++;
+        head.assign(std::size_t(1) << hashBits, -1);
+        if (prev.size() < end) prev.resize(end);
+        tokens.clear();
+        auto hash = [&](std::size_t i) {
+            std::uint32_t v = buf[i] << 16 | buf[i + 1] << 8 | buf[i + 2];
+            return (v * 2654435761u) >> (32 - hashBits);
+        };
+        auto insert = [&](std::size_t i) {
+            if (i + 3 > end) return;
+            std::uint32_t h = hash(i);
+            prev[i] = head[h];
+            head[h] = static_cast<std::int32_t>(i);
+        };
+
+        for (std::size_t i = 0; i < start; i++) insert(i);
+
+        std::uint32_t literalFreq[286] = {0}, distanceFreq[30] = {0};
+        std::size_t pos = start;
+        while (pos < end) {
+            std::size_t bestLength = 0, bestDistance = 0;
+            if (pos + 3 <= end) {
+                std::size_t maxLength = std::min<std::size_t>(258, end - pos);
+                std::size_t limit = pos > windowSize ? pos - windowSize : 0;
+                std::int32_t candidate = head[hash(pos)];
+                for (int chain = maxChain; candidate >= 0 && std::size_t(candidate) >= limit && chain > 0; chain--) {
+                    const unsigned char* a = buf + candidate;
+                    const unsigned char* b = buf + pos;
+                    if (a[bestLength] == b[bestLength]) {
+                        std::size_t length = 0;
+                        while (length < maxLength && a[length] == b[length]) length++;
+                        if (length > bestLength) {
+                            bestLength = length;
+                            bestDistance = pos - candidate;
+                            if (length == maxLength) break;
+                        }
+                    }
+                    candidate = prev[candidate];
+                }
+            }
+
+            if (bestLength >= 3) {
+                tokens.push_back({static_cast<std::uint16_t>(bestLength), static_cast<std::uint16_t>(bestDistance)});
+                literalFreq[257 + t.lengthSymbol[bestLength]]++;
+                distanceFreq[bestDistance <= 256 ? t.distanceSymbol[bestDistance - 1]
+                                                 : t.distanceSymbol[256 + ((bestDistance - 1) >> 7)]]++;
+                for (std::size_t i = 0; i < bestLength; i++) insert(pos + i);
+                pos += bestLength;
+            } else {
+                tokens.push_back({buf[pos], 0});
+                literalFreq[buf[pos]]++;
+                insert(pos);
+                pos++;
+            }
+        }
+        literalFreq[256] = 1;
+
+        // Dynamic code: lengths for both alphabets, then their run-length
+        // encoding ({symbol, extra bits value, extra bit count}) and its code.
+        unsigned char literalBits[286], distanceBits[30];
+        buildLengths(literalFreq, 286, 15, literalBits);
+        buildLengths(distanceFreq, 30, 15, distanceBits);
+        int literalCount = 286, distanceCount = 30;
+        while (literalCount > 257 && !literalBits[literalCount - 1]) literalCount--;
+        while (distanceCount > 1 && !distanceBits[distanceCount - 1]) distanceCount--;
+
+        unsigned char lengths[286 + 30];
+        std::copy(literalBits, literalBits + literalCount, lengths);
+        std::copy(distanceBits, distanceBits + distanceCount, lengths + literalCount);
+        int total = literalCount + distanceCount;
+        std::vector<std::array<unsigned char, 3>> runs;
+        std::uint32_t runFreq[19] = {0};
+        auto push = [&](int symbol, int extra, int extraBits) {
+            runs.push_back({static_cast<unsigned char>(symbol), static_cast<unsigned char>(extra),
+                            static_cast<unsigned char>(extraBits)});
+            runFreq[symbol]++;
+        };
+        for (int i = 0; i < total;) {
+            int len = lengths[i], run = 1;
+            while (i + run < total && lengths[i + run] == len) run++;
+            i += run;
+            if (len == 0) {
+                while (run >= 11) {
+                    int r = std::min(run, 138);
+                    push(18, r - 11, 7);
+                    run -= r;
+                }
+                if (run >= 3) {
+                    push(17, run - 3, 3);
+                    run = 0;
+                }
+            } else {
+                push(len, 0, 0);
+                run--;
+                while (run >= 3) {
+                    int r = std::min(run, 6);
+                    push(16, r - 3, 2);
+                    run -= r;
+                }
+            }
+            while (run-- > 0) push(len, 0, 0);
+        }
+        static const int order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+        unsigned char runBits[19];
+        buildLengths(runFreq, 19, 7, runBits);
+        int runCount = 19;
+        while (runCount > 4 && !runBits[order[runCount - 1]]) runCount--;
+
+        std::uint64_t dynamicCost = 14 + 3 * runCount, fixedCost = 0;
+        for (const auto& r : runs) dynamicCost += runBits[r[0]] + r[2];
+        for (int s = 0; s < 286; s++) {
+            std::uint64_t extra = s >= 257 ? lengthExtra[s - 257] : 0;
+            dynamicCost += literalFreq[s] * (literalBits[s] + extra);
+            fixedCost += literalFreq[s] * (t.literalBits[s] + extra);
+        }
+        for (int s = 0; s < 30; s++) {
+            dynamicCost += distanceFreq[s] * (distanceBits[s] + distanceExtra[s]);
+            fixedCost += distanceFreq[s] * (5 + distanceExtra[s]);
+        }
+
+        unsigned short literalCode[286], distanceCode[30];
+        BitWriter bits(out);
+        bits.put(last ? 1 : 0, 1);
+        if (dynamicCost < fixedCost) {
+            bits.put(2, 2);
+            bits.put(literalCount - 257, 5);
+            bits.put(distanceCount - 1, 5);
+            bits.put(runCount - 4, 4);
+            for (int i = 0; i < runCount; i++) bits.put(runBits[order[i]], 3);
+            unsigned short runCode[19];
+            assignCodes(runBits, 19, runCode);
+            for (const auto& r : runs) {
+                bits.put(runCode[r[0]], runBits[r[0]]);
+                bits.put(r[1], r[2]);
+            }
+            assignCodes(literalBits, 286, literalCode);
+            assignCodes(distanceBits, 30, distanceCode);
+        } else {
+            bits.put(1, 2);
+            std::copy(t.literalCode, t.literalCode + 286, literalCode);
+            std::copy(t.literalBits, t.literalBits + 286, literalBits);
+            std::copy(t.distanceCode, t.distanceCode + 30, distanceCode);
+            std::fill(distanceBits, distanceBits + 30, 5);
+        }
+
+        for (const Token& token : tokens) {
+            if (token.distance == 0) {
+                bits.put(literalCode[token.length], literalBits[token.length]);
+                continue;
+            }
+            int s = t.lengthSymbol[token.length];
+            bits.put(literalCode[257 + s], literalBits[257 + s]);
+            bits.put(token.length - lengthBase[s], lengthExtra[s]);
+            int d = token.distance <= 256 ? t.distanceSymbol[token.distance - 1]
+                                          : t.distanceSymbol[256 + ((token.distance - 1) >> 7)];
+            bits.put(distanceCode[d], distanceBits[d]);
+            bits.put(token.distance - distanceBase[d], distanceExtra[d]);
+        }
+        bits.put(literalCode[256], literalBits[256]);  // end of block
+
+        if (!last) {
+            bits.put(0, 3);  // empty stored block
+            bits.align();
+            out.append("\x00\x00\xFF\xFF", 4);
+        } else {
+            bits.align();
+        }
+    }
+
+    // Canonical Huffman decoding table indexed by the next maxBits input
+    // bits; each entry holds symbol << 4 | code length (0: invalid code).
+    struct Decoder {
+        std::vector<unsigned short> table;
+        int maxBits = 0;
+
+        bool build(const unsigned char* lengths, int count) {
+            int perLength[16] = {0};
+            for (int i = 0; i < count; i++) perLength[lengths[i]]++;
+            perLength[0] = 0;
+            int left = 1;
+            for (int len = 1; len < 16; len++) {
+                left = (left << 1) - perLength[len];
+                if (left < 0) return false;  // over-subscribed
+            }
+            maxBits = 0;
+            for (int len = 1; len < 16; len++) {
+                if (perLength[len]) maxBits = len;
+            }
+            table.assign(std::size_t(1) << maxBits, 0);
+
+            unsigned next[16] = {0};
+            unsigned code = 0;
+            for (int len = 1; len < 16; len++) {
+                code = (code + perLength[len - 1]) << 1;
+                next[len] = code;
+            }
+            for (int symbol = 0; symbol < count; symbol++) {
+                int len = lengths[symbol];
+                if (!len) continue;
+                unsigned reversed = reverseBits(next[len]++, len);
+                for (std::size_t i = reversed; i < table.size(); i += std::size_t(1) << len) {
+                    table[i] = static_cast<unsigned short>(symbol << 4 | len);
+                }
+            }
+            return true;
+        }
+    };
+
+    // Streams one deflated entry from the archive to a file. Output is
+    // buffered with the last 32 KiB kept for back-references.
+    class Inflater {
+    public:
+        Inflater(std::FILE* in, std::uint64_t size, std::ofstream& out) : in(in), remaining(size), out(out) {
+            history.reserve(flushAt + 258);
+        }
+
+        bool run() {
+            for (bool final = false; !final;) {
+                final = get(1);
+                int type = get(2);
+                bool ok = type == 0 ? stored() : type == 1 ? fixed() : type == 2 ? dynamic() : false;
+                if (!ok || failed) return false;
+            }
+            flush(0);
+            return !failed && padding <= used;
+        }
+
+        std::uint32_t crc = 0;
+        std::uint64_t size = 0;
+
+    private:
+        static const std::size_t flushAt = 256 * 1024;
+
+        std::FILE* in;
+        std::uint64_t remaining;
+        std::ofstream& out;
+        unsigned char input[65536];
+        std::size_t inputPos = 0, inputEnd = 0;
+        std::uint64_t bits = 0;
+        int used = 0;
+        int padding = 0;  // zero bits added past the end of the entry
+        bool failed = false;
+        std::string history;
+
+        void refill(int need) {
+            while (used < need) {
+                if (inputPos == inputEnd) {
+                    std::size_t want = static_cast<std::size_t>(std::min<std::uint64_t>(sizeof input, remaining));
+                    inputEnd = want ? std::fread(input, 1, want, in) : 0;
+                    inputPos = 0;
+                    remaining -= inputEnd;
+                }
+                std::uint64_t byte = 0;
+                if (inputPos < inputEnd) byte = input[inputPos++];
+                else padding += 8;
+                bits |= byte << used;
+                used += 8;
+            }
+        }
+
+        std::uint32_t get(int count) {
+            if (count == 0) return 0;
+            refill(count);
+            std::uint32_t value = static_cast<std::uint32_t>(bits & ((std::uint64_t(1) << count) - 1));
+            bits >>= count;
+            used -= count;
+            if (padding > used) failed = true;  // read past the compressed data
+            return value;
+        }
+
+        int decode(const Decoder& d) {
+            refill(d.maxBits);
+            unsigned short entry = d.table[bits & ((std::uint64_t(1) << d.maxBits) - 1)];
+            int len = entry & 15;
+            if (len == 0) {
+                failed = true;
+                return -1;
+            }
+            bits >>= len;
+            used -= len;
+            if (padding > used) failed = true;
+            return entry >> 4;
+        }
+
+        void flush(std::size_t keep) {
+            if (history.size() <= keep) return;
+            std::size_t n = history.size() - keep;
+            crc = crc32(crc, reinterpret_cast<const unsigned char*>(history.data()), n);
+            size += n;
+            out.write(history.data(), n);
+            history.erase(0, n);
+        }
+
+        void emit(char c) {
+            history += c;
+            if (history.size() >= flushAt) flush(windowSize);
+        }
+
+        bool stored() {
+            get(used % 8);
+            std::uint32_t length = get(16);
+            std::uint32_t complement = get(16);
+            if ((length ^ 0xFFFF) != complement) return false;
+            for (std::uint32_t i = 0; i < length && !failed; i++) emit(static_cast<char>(get(8)));
+            return true;
+        }
+
+        bool codes(const Decoder& literals, const Decoder& distances) {
+            while (!failed) {
+                int symbol = decode(literals);
+                if (symbol < 0) return false;
+                if (symbol < 256) {
+                    emit(static_cast<char>(symbol));
+                    continue;
+                }
+                if (symbol == 256) return true;
+                symbol -= 257;
+                if (symbol >= 29) return false;
+                std::size_t length = lengthBase[symbol] + get(lengthExtra[symbol]);
+                int d = decode(distances);
+                if (d < 0 || d >= 30) return false;
+                std::size_t distance = distanceBase[d] + get(distanceExtra[d]);
+                if (distance > history.size()) return false;
+                for (std::size_t i = 0; i < length; i++) emit(history[history.size() - distance]);
+            }
+            return false;
+        }
+
+        bool fixed() {
+            static const struct FixedDecoders {
+                Decoder literals, distances;
+                FixedDecoders() {
+                    unsigned char lengths[288];
+                    for (int i = 0; i < 288; i++) lengths[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+                    literals.build(lengths, 288);
+                    std::fill(lengths, lengths + 30, 5);
+                    distances.build(lengths, 30);
+                }
+            } decoders;
+            return codes(decoders.literals, decoders.distances);
+        }
+
+        bool dynamic() {
+            static const int order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+            int literalCount = get(5) + 257;
+            int distanceCount = get(5) + 1;
+            int codeCount = get(4) + 4;
+            if (literalCount > 286 || distanceCount > 30) return false;
+
+            unsigned char lengths[286 + 30] = {0};
+            for (int i = 0; i < codeCount; i++) lengths[order[i]] = static_cast<unsigned char>(get(3));
+            Decoder lengthCodes;
+            if (!lengthCodes.build(lengths, 19)) return false;
+
+            std::fill(lengths, lengths + 19, 0);
+            int total = literalCount + distanceCount;
+            for (int i = 0; i < total && !failed;) {
+                int symbol = decode(lengthCodes);
+                if (symbol < 0) return false;
+                if (symbol < 16) {
+                    lengths[i++] = static_cast<unsigned char>(symbol);
+                    continue;
+                }
+                unsigned char value = 0;
+                int repeat;
+                if (symbol == 16) {
+                    if (i == 0) return false;
+                    value = lengths[i - 1];
+                    repeat = 3 + get(2);
+                } else if (symbol == 17) {
+                    repeat = 3 + get(3);
+                } else {
+                    repeat = 11 + get(7);
+                }
+                if (i + repeat > total) return false;
+                while (repeat--) lengths[i++] = value;
+            }
+            if (lengths[256] == 0) return false;  // no end-of-block code
+
+            Decoder literals, distances;
+            return literals.build(lengths, literalCount) && distances.build(lengths + literalCount, distanceCount) &&
+                   codes(literals, distances);
+        }
+    };
+
+    void put16(std::string& out, std::uint32_t v) {
+        out += static_cast<char>(v & 0xFF);
+        out += static_cast<char>(v >> 8 & 0xFF);
+    }
+
+    void put32(std::string& out, std::uint32_t v) {
+        put16(out, v & 0xFFFF);
+        put16(out, v >> 16);
+    }
+
+    void put64(std::string& out, std::uint64_t v) {
+        put32(out, static_cast<std::uint32_t>(v));
+        put32(out, static_cast<std::uint32_t>(v >> 32));
+    }
+
+    std::uint32_t get16(const unsigned char* p) { return p[0] | p[1] << 8; }
+    std::uint32_t get32(const unsigned char* p) { return get16(p) | get16(p + 2) << 16; }
+    std::uint64_t get64(const unsigned char* p) { return get32(p) | std::uint64_t(get32(p + 4)) << 32; }
+
+    // std::fseek takes a long, which is 32 bits on Windows; ZIP64 offsets
+    // past 2 GiB need the 64-bit variants.
+    bool seekFile(std::FILE* file, std::uint64_t offset, int origin) {
+#ifdef _WIN32
+        if (offset > static_cast<std::uint64_t>(std::numeric_limits<__int64>::max())) return false;
+        return _fseeki64(file, static_cast<__int64>(offset), origin) == 0;
+#else
+        if (offset > static_cast<std::uint64_t>(std::numeric_limits<off_t>::max())) return false;
+        return fseeko(file, static_cast<off_t>(offset), origin) == 0;
+#endif
+    }
+
+    struct Entry {
+        std::string name;
+        std::uint64_t size = 0;
+        std::uint64_t compressed = 0;
+        std::uint64_t offset = 0;  // of the local header
+        std::uint32_t crc = 0;
+        std::uint16_t method = 8;  // 0 stored, 8 deflated
+        bool descriptor = false;   // sizes and CRC follow the data
+    };
+
+    // One chunk of one file, compressed by a worker.
+    struct Piece {
+        std::size_t entry;
+        std::uint64_t offset;
+        std::size_t length;
+        std::size_t dictionary = 0;  // leading bytes of raw that precede the chunk
+        std::string raw, data;
+        std::uint32_t crc = 0;
+        bool stored = false;
+        std::string error;
+    };
+}
+
+ArchiveStats writeArchive(const std::string& path, const std::vector<std::string>& files, ThreadPool& pool,
+                          const std::function<void(std::size_t, std::size_t)>& progress) {
+    auto start = std::chrono::steady_clock::now();
+    ArchiveStats stats;
+    auto finish = [&](const std::string& error) {
+        stats.error = error;
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    };
+
+    std::vector<Entry> entries(files.size());
+    for (std::size_t i = 0; i < files.size(); i++) {
+        std::error_code ec;
+        entries[i].name = files[i];
+        entries[i].size = std::filesystem::file_size(files[i], ec);
+        if (ec) return finish("cannot read " + files[i]);
+        if (entries[i].size >= 0xFFFFFFFFu - entries[i].size / 8 - 1024) return finish(files[i] + " is too large");
+        if (files[i].size() > 0xFFFF) return finish("file name too long");
+    }
+
+    std::time_t now = std::time(nullptr);
+    std::tm local = *std::localtime(&now);
+    std::uint32_t dosTime = local.tm_hour << 11 | local.tm_min << 5 | local.tm_sec / 2;
+    std::uint32_t dosDate = (std::max(local.tm_year - 80, 0)) << 9 | (local.tm_mon + 1) << 5 | local.tm_mday;
+
+    std::string tmp = path + ".tmp";
+    std::FILE* out = std::fopen(tmp.c_str(), "wb");
+    if (!out) return finish("cannot create " + tmp);
+    std::vector<char> outBuffer(1 << 20);
+    std::setvbuf(out, outBuffer.data(), _IOFBF, outBuffer.size());
+    std::uint64_t written = 0;
+    bool ok = true;
+    auto write = [&](const std::string& bytes) {
+        ok = ok && std::fwrite(bytes.data(), 1, bytes.size(), out) == bytes.size();
+        written += bytes.size();
+    };
+    std::string header;
+    auto localHeader = [&](const Entry& e) {
+        header.clear();
+        put32(header, localSignature);
+        put16(header, 20);
+        put16(header, e.descriptor ? 8 : 0);
+        put16(header, e.method);
+        put16(header, dosTime);
+        put16(header, dosDate);
+        put32(header, e.descriptor ? 0 : e.crc);
+        put32(header, e.descriptor ? 0 : static_cast<std::uint32_t>(e.compressed));
+        put32(header, e.descriptor ? 0 : static_cast<std::uint32_t>(e.size));
+        put16(header, static_cast<std::uint32_t>(e.name.size()));
+        put16(header, 0);
+        header += e.name;
+        write(header);
+    };
+
+    // Batches of chunks are compressed on the pool, then written in order on
+    // this thread. A batch holds at most batchBytes of input.
+    std::size_t nextEntry = 0, filesDone = 0;
+    std::uint64_t nextOffset = 0;
+    std::vector<Piece> batch;
+    while (ok && nextEntry < entries.size()) {
+        batch.clear();
+        std::size_t bytes = 0;
+        while (nextEntry < entries.size() && batch.size() < batchItems && bytes < batchBytes) {
+            Piece piece;
+            piece.entry = nextEntry;
+            piece.offset = nextOffset;
+            piece.length = static_cast<std::size_t>(std::min<std::uint64_t>(chunkSize, entries[nextEntry].size - nextOffset));
+            bytes += piece.length;
+            batch.push_back(std::move(piece));
+            nextOffset += batch.back().length;
+            if (nextOffset >= entries[nextEntry].size) {
+                nextEntry++;
+                nextOffset = 0;
+            }
+        }
+
+        pool.parallelFor(batch.size(), [&](std::size_t i) {
+            Piece& p = batch[i];
+            const Entry& e = entries[p.entry];
+            p.dictionary = static_cast<std::size_t>(std::min<std::uint64_t>(p.offset, windowSize));
+            p.raw.resize(p.dictionary + p.length);
+            std::ifstream in(e.name, std::ios::binary);
+            in.seekg(static_cast<std::streamoff>(p.offset - p.dictionary));
+            if (!in.read(&p.raw[0], p.raw.size())) {
+                p.error = "cannot read " + e.name;
+                return;
+            }
+            const unsigned char* raw = reinterpret_cast<const unsigned char*>(p.raw.data());
+            p.crc = crc32(0, raw + p.dictionary, p.length);
+            bool last = p.offset + p.length >= e.size;
+            deflateChunk(raw, p.dictionary, p.raw.size(), last, p.data);
+            // A file that fits one chunk is stored as-is if deflate does not help.
+            p.stored = p.offset == 0 && last && p.data.size() >= p.length;
+        });
+
+        for (Piece& p : batch) {
+            if (!p.error.empty()) {
+                ok = false;
+                stats.error = p.error;
+                break;
+            }
+            Entry& e = entries[p.entry];
+            bool first = p.offset == 0;
+            bool last = p.offset + p.length >= e.size;
+            if (first) {
+                e.offset = written;
+                e.descriptor = !last;
+                if (p.stored) {
+                    e.method = 0;
+                    e.compressed = p.length;
+                } else {
+                    e.compressed = p.data.size();
+                }
+                e.crc = p.crc;
+                localHeader(e);
+            } else {
+                e.crc = crc32(e.crc, reinterpret_cast<const unsigned char*>(p.raw.data()) + p.dictionary, p.length);
+                e.compressed += p.data.size();
+            }
+            if (p.stored) write(p.raw.substr(p.dictionary));
+            else write(p.data);
+
+            if (last) {
+                if (e.descriptor) {
+                    header.clear();
+                    put32(header, descriptorSignature);
+                    put32(header, e.crc);
+                    put32(header, static_cast<std::uint32_t>(e.compressed));
+                    put32(header, static_cast<std::uint32_t>(e.size));
+                    write(header);
+                }
+                stats.bytes += e.size;
+                filesDone++;
+            }
+            std::string().swap(p.raw);
+            std::string().swap(p.data);
+        }
+        if (progress) progress(filesDone, entries.size());
+    }
+
+    // Central directory, with a ZIP64 offset field for entries past 4 GiB.
+    std::uint64_t centralStart = written;
+    for (const Entry& e : entries) {
+        if (!ok) break;
+        bool zip64 = e.offset >= 0xFFFFFFFFu;
+        header.clear();
+        put32(header, centralSignature);
+        put16(header, zip64 ? 45 : 20);
+        put16(header, zip64 ? 45 : 20);
+        put16(header, e.descriptor ? 8 : 0);
+        put16(header, e.method);
+        put16(header, dosTime);
+        put16(header, dosDate);
+        put32(header, e.crc);
+        put32(header, static_cast<std::uint32_t>(e.compressed));
+        put32(header, static_cast<std::uint32_t>(e.size));
+        put16(header, static_cast<std::uint32_t>(e.name.size()));
+        put16(header, zip64 ? 12 : 0);
+        put16(header, 0);
+        put16(header, 0);
+        put16(header, 0);
+        put32(header, 0);
+        put32(header, zip64 ? 0xFFFFFFFFu : static_cast<std::uint32_t>(e.offset));
+        header += e.name;
+        if (zip64) {
+            put16(header, 1);
+            put16(header, 8);
+            put64(header, e.offset);
+        }
+        write(header);
+    }
+    std::uint64_t centralSize = written - centralStart;
+
+    header.clear();
+    bool zip64End = entries.size() >= 0xFFFF || centralStart >= 0xFFFFFFFFu;
+    if (zip64End) {
+        std::uint64_t recordOffset = written;
+        put32(header, zip64EndSignature);
+        put64(header, 44);
+        put16(header, 45);
+        put16(header, 45);
+        put32(header, 0);
+        put32(header, 0);
+        put64(header, entries.size());
+        put64(header, entries.size());
+        put64(header, centralSize);
+        put64(header, centralStart);
+        put32(header, zip64LocatorSignature);
+        put32(header, 0);
+        put64(header, recordOffset);
+        put32(header, 1);
+    }
+    put32(header, endSignature);
+    put16(header, 0);
+    put16(header, 0);
+    put16(header, zip64End ? 0xFFFF : static_cast<std::uint32_t>(entries.size()));
+    put16(header, zip64End ? 0xFFFF : static_cast<std::uint32_t>(entries.size()));
+    put32(header, static_cast<std::uint32_t>(std::min<std::uint64_t>(centralSize, 0xFFFFFFFFu)));
+    put32(header, zip64End ? 0xFFFFFFFFu : static_cast<std::uint32_t>(centralStart));
+    put16(header, 0);
+    write(header);
+
+    ok = std::fclose(out) == 0 && ok;
+    std::error_code ec;
+    if (!ok) {
+        std::filesystem::remove(tmp, ec);
+        return finish(stats.error.empty() ? "cannot write " + tmp : stats.error);
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) return finish("cannot replace " + path);
+    stats.files = entries.size();
+    stats.archiveBytes = written;
+    return finish("");
+}
+
+ArchiveStats extractArchive(const std::string& path, ThreadPool& pool,
+                            const std::function<bool(const std::string&)>& accept,
+                            const std::function<void(std::size_t, std::size_t)>& progress) {
+    auto start = std::chrono::steady_clock::now();
+    ArchiveStats stats;
+    auto finish = [&](const std::string& error) {
+        stats.error = error;
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    };
+
+    std::error_code ec;
+    std::uint64_t archiveSize = std::filesystem::file_size(path, ec);
+    if (ec) return finish("cannot open " + path);
+    stats.archiveBytes = archiveSize;
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    if (!in) return finish("cannot open " + path);
+    auto readAt = [&](std::uint64_t offset, std::size_t size, std::vector<unsigned char>& buf) {
+        buf.resize(size);
+        return offset + size <= archiveSize && seekFile(in, offset, SEEK_SET) &&
+               std::fread(buf.data(), 1, size, in) == size;
+    };
+
+    // The end record sits in the last 64 KiB + 22 bytes (its comment is at
+    // most 64 KiB); search backwards for its signature.
+    std::vector<unsigned char> tail, buf;
+    std::size_t tailSize = static_cast<std::size_t>(std::min<std::uint64_t>(archiveSize, 0xFFFF + 22));
+    std::uint64_t tailStart = archiveSize - tailSize;
+    if (tailSize < 22 || !readAt(tailStart, tailSize, tail)) {
+        std::fclose(in);
+        return finish(path + " is not a ZIP archive");
+    }
+    std::size_t end = tailSize - 22 + 1;
+    while (end-- > 0 && get32(&tail[end]) != endSignature) {}
+    if (end == std::size_t(-1)) {
+        std::fclose(in);
+        return finish(path + " is not a ZIP archive");
+    }
+    std::uint64_t count = get16(&tail[end + 10]);
+    std::uint64_t centralSize = get32(&tail[end + 12]);
+    std::uint64_t centralStart = get32(&tail[end + 16]);
+    std::uint64_t endOffset = tailStart + end;
+    if (endOffset >= 20 && readAt(endOffset - 20, 20, buf) && get32(buf.data()) == zip64LocatorSignature) {
+        std::uint64_t recordOffset = get64(&buf[8]);
+        if (!readAt(recordOffset, 56, buf) || get32(buf.data()) != zip64EndSignature) {
+            std::fclose(in);
+            return finish("damaged ZIP64 end record");
+        }
+        count = get64(&buf[32]);
+        centralSize = get64(&buf[40]);
+        centralStart = get64(&buf[48]);
+    }
+    std::vector<unsigned char> central;
+    if (centralSize > archiveSize || !readAt(centralStart, static_cast<std::size_t>(centralSize), central)) {
+        std::fclose(in);
+        return finish("damaged central directory");
+    }
+    std::fclose(in);
+
+    std::vector<Entry> entries;
+    std::size_t at = 0;
+    for (std::uint64_t i = 0; i < count; i++) {
+        if (at + 46 > central.size() || get32(&central[at]) != centralSignature) return finish("damaged central directory");
+        const unsigned char* h = &central[at];
+        std::size_t nameSize = get16(h + 28), extraSize = get16(h + 30), commentSize = get16(h + 32);
+        if (at + 46 + nameSize + extraSize + commentSize > central.size()) return finish("damaged central directory");
+        Entry e;
+        std::uint32_t flags = get16(h + 8);
+        e.method = static_cast<std::uint16_t>(get16(h + 10));
+        e.crc = get32(h + 16);
+        e.compressed = get32(h + 20);
+        e.size = get32(h + 24);
+        e.offset = get32(h + 42);
+        e.name.assign(reinterpret_cast<const char*>(h + 46), nameSize);
+
+        // ZIP64 extra field: 64-bit values for whichever fields are saturated.
+        const unsigned char* extra = h + 46 + nameSize;
+        for (std::size_t x = 0; x + 4 <= extraSize;) {
+            std::size_t id = get16(extra + x), size = get16(extra + x + 2);
+            const unsigned char* field = extra + x + 4;
+            const unsigned char* fieldEnd = field + std::min(size, extraSize - x - 4);
+            if (id == 1) {
+                for (std::uint64_t* value : {&e.size, &e.compressed, &e.offset}) {
+                    if (*value == 0xFFFFFFFFu && field + 8 <= fieldEnd) {
+                        *value = get64(field);
+                        field += 8;
+                    }
+                }
+            }
+            x += 4 + size;
+        }
+        at += 46 + nameSize + extraSize + commentSize;
+
+        if (flags & 1) return finish(e.name + " is encrypted");
+        if (e.method != 0 && e.method != 8) return finish(e.name + " uses an unsupported compression method");
+        if (!e.name.empty() && e.name.back() == '/') continue;  // directory
+        if (!accept(e.name)) {
+            stats.skipped++;
+            continue;
+        }
+        entries.push_back(std::move(e));
+    }
+
+    // Every entry is inflated on the pool into its own .restore file.
+    std::vector<std::string> errors(entries.size());
+    pool.parallelFor(entries.size(), [&](std::size_t i) {
+        const Entry& e = entries[i];
+        std::FILE* archive = std::fopen(path.c_str(), "rb");
+        if (!archive) {
+            errors[i] = "cannot open " + path;
+            return;
+        }
+        unsigned char local[30];
+        bool ok = seekFile(archive, e.offset, SEEK_SET) &&
+                  std::fread(local, 1, sizeof local, archive) == sizeof local && get32(local) == localSignature &&
+                  seekFile(archive, get16(local + 26) + get16(local + 28), SEEK_CUR);
+        if (!ok) {
+            std::fclose(archive);
+            errors[i] = "damaged entry " + e.name;
+            return;
+        }
+
+        std::ofstream out(e.name + ".restore", std::ios::binary);
+        std::uint32_t crc = 0;
+        std::uint64_t size = 0;
+        if (e.method == 8) {
+            Inflater inflater(archive, e.compressed, out);
+            ok = inflater.run();
+            crc = inflater.crc;
+            size = inflater.size;
+        } else {
+            std::vector<char> block(65536);
+            for (std::uint64_t left = e.compressed; ok && left > 0;) {
+                std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(left, block.size()));
+                ok = std::fread(block.data(), 1, n, archive) == n;
+                crc = crc32(crc, reinterpret_cast<const unsigned char*>(block.data()), n);
+                out.write(block.data(), n);
+                size += n;
+                left -= n;
+            }
+        }
+        std::fclose(archive);
+        out.close();
+        if (!ok || !out || crc != e.crc || size != e.size) errors[i] = "damaged entry " + e.name;
+    }, progress ? [&](std::size_t done) { progress(done, entries.size()); } : std::function<void(std::size_t)>());
+
+    std::string error;
+    for (const std::string& e : errors) {
+        if (!e.empty()) {
+            error = e;
+            break;
+        }
+    }
+
+    // Each original is moved aside to <name>.original before its
+    // replacement goes in, so a failure part way can put every file back.
+    std::size_t swapped = 0;
+    std::vector<bool> hadOriginal(entries.size());
+    for (; error.empty() && swapped < entries.size(); swapped++) {
+        const std::string& name = entries[swapped].name;
+        hadOriginal[swapped] = std::filesystem::exists(name, ec);
+        if (hadOriginal[swapped]) {
+            std::filesystem::rename(name, name + ".original", ec);
+            if (ec) {
+                error = "cannot replace " + name;
+                break;
+            }
+        }
+        std::filesystem::rename(name + ".restore", name, ec);
+        if (ec) {
+            error = "cannot replace " + name;
+            if (hadOriginal[swapped]) std::filesystem::rename(name + ".original", name, ec);
+            if (ec) stats.partial = true;
+            break;
+        }
+    }
+
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        const std::string& name = entries[i].name;
+        std::filesystem::remove(name + ".restore", ec);
+        if (i >= swapped) continue;
+        if (error.empty()) {
+            if (hadOriginal[i]) std::filesystem::remove(name + ".original", ec);
+            stats.bytes += entries[i].size;
+        } else {
+            if (hadOriginal[i]) std::filesystem::rename(name + ".original", name, ec);
+            else std::filesystem::remove(name, ec);
+            if (ec) stats.partial = true;
+        }
+    }
+    if (error.empty()) stats.files = entries.size();
+    return finish(error);
+}
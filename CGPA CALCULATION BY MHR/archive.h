@@ -0,0 +1,38 @@
+#ifndef ARCHIVE
+#define ARCHIVE
+
+#include "threadpool.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct ArchiveStats {
+    std::size_t files = 0;
+    std::size_t skipped = 0;          // entries refused by accept() on extract
+    std::uint64_t bytes = 0;          // uncompressed
+    std::uint64_t archiveBytes = 0;
+    double seconds = 0;
+    std::string error;                // empty on success
+    bool partial = false;             // extract failed and could not put every original back
+
+    double bytesPerSecond() const { return seconds > 0 ? bytes / seconds : 0; }
+};
+
+// Writes the listed files into a ZIP archive at path, stored under the names
+// given. Files are deflated in 1 MiB chunks on the pool, one bounded batch at
+// a time, so memory use does not grow with the data. The archive is built in
+// path.tmp and renamed over path once complete.
+ArchiveStats writeArchive(const std::string& path, const std::vector<std::string>& files, ThreadPool& pool,
+                          const std::function<void(std::size_t done, std::size_t total)>& progress = nullptr);
+
+// Extracts a ZIP archive (stored or deflated entries) into the working
+// directory. Entries whose name accept() refuses are skipped. Every entry is
+// first inflated to <name>.restore and checked against its CRC; the originals
+// are only replaced once all of them are intact. If replacing one fails,
+// those already replaced are put back; partial is set if that fails too.
+ArchiveStats extractArchive(const std::string& path, ThreadPool& pool,
+                            const std::function<bool(const std::string& name)>& accept,
+                            const std::function<void(std::size_t done, std::size_t total)>& progress = nullptr);
+
+#endif
@@ -0,0 +1,116 @@
+#include "bulkimport.h"
+#include "grades.h"
+#include "cgpaledger.h"
+#include "gradelog.h"
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+
+namespace {
+    bool parseInt(std::string_view field, int& value) {
+        while (!field.empty() && field.front() == ' ') field.remove_prefix(1);
+        while (!field.empty() && (field.back() == ' ' || field.back() == '\r')) field.remove_suffix(1);
+        auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+        return result.ec == std::errc() && result.ptr == field.data() + field.size();
+    }
+
+    // Rows waiting to be appended to one student's file, and what they add
+    // to the student's CGPA totals.
+    struct Pending {
+        std::string rows;
+        CgpaTotals added;
+        bool imported = false;   // some rows reached the file
+        bool failed = false;     // some rows did not
+    };
+
+    void flush(std::unordered_map<std::string, Pending>& pending, ImportStats& stats) {
+        CgpaLedger& ledger = cgpaLedger();
+        for (auto& [student, p] : pending) {
+            if (p.rows.empty()) continue;
+            CgpaTotals totals = ledger.totals(student);
+            std::string path = student + ".csv";
+            std::error_code ec;
+            std::uintmax_t size = std::filesystem::exists(path, ec) ? std::filesystem::file_size(path, ec) : 0;
+            std::ofstream out(path, std::ios::app | std::ios::binary);
+            out.write(p.rows.data(), p.rows.size());
+            out.close();
+            if (out) {
+                totals += p.added;
+                ledger.commit(student, totals);
+                stats.rows += p.added.courses;
+                p.imported = true;
+            } else {
+                // Drop whatever part of the batch got in, so the file does
+                // not end in half a row.
+                if (!ec) std::filesystem::resize_file(path, size, ec);
+                stats.failed += p.added.courses;
+                if (!p.failed) stats.failedStudents++;
+                p.failed = true;
+            }
+            std::string().swap(p.rows);
+            p.added = CgpaTotals();
+        }
+    }
+}
+
+ImportStats importGrades(std::istream& in, std::size_t flushBytes) {
+    auto start = std::chrono::steady_clock::now();
+    ImportStats stats;
+    const GradeScale& scale = gradeScale();
+
+    // Rows are appended to the files directly, so logged rows have to be in
+    // the files first or they would land on the appended row numbers.
+    if (!gradeLog().checkpoint()) {
+        stats.error = "logged grade changes could not be written to the grade files";
+        return stats;
+    }
+
+    std::unordered_map<std::string, Pending> pending;
+    std::size_t pendingBytes = 0;
+    std::string line;
+
+    while (std::getline(in, line)) {
+        std::string_view rest(line);
+        std::size_t c1 = rest.find(',');
+        std::size_t c2 = c1 == std::string_view::npos ? c1 : rest.find(',', c1 + 1);
+        std::size_t c3 = c2 == std::string_view::npos ? c2 : rest.find(',', c2 + 1);
+        int marks, credit;
+        if (c3 == std::string_view::npos || c1 == 0 ||
+            !parseInt(rest.substr(c2 + 1, c3 - c2 - 1), marks) ||
+            !parseInt(rest.substr(c3 + 1), credit)) {
+            if (!line.empty()) stats.skipped++;
+            continue;
+        }
+
+        Pending& p = pending[std::string(rest.substr(0, c1))];
+        std::string& rows = p.rows;
+        Grade grade = scale.gradeFor(marks);
+        std::size_t before = rows.size();
+        rows.append(rest.substr(c1 + 1, c2 - c1 - 1));
+        rows += ',';
+        rows += std::to_string(marks);
+        rows += ',';
+        rows += std::to_string(credit);
+        rows += ',';
+        rows += gradeName(grade);
+        rows += '\n';
+        p.added.add(grade, credit);
+        pendingBytes += rows.size() - before;
+
+        if (pendingBytes >= flushBytes) {
+            flush(pending, stats);
+            pendingBytes = 0;
+        }
+    }
+    flush(pending, stats);
+
+    for (const auto& entry : pending) {
+        if (entry.second.imported) stats.students++;
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
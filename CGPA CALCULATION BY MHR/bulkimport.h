@@ -0,0 +1,28 @@
+#ifndef BULK_IMPORT
+#define BULK_IMPORT
+
+#include <istream>
+#include <cstddef>
+#include <string>
+
+struct ImportStats {
+    std::size_t rows = 0;             // rows written to the students' files
+    std::size_t skipped = 0;          // malformed rows
+    std::size_t failed = 0;           // rows lost because a file could not be written
+    std::size_t failedStudents = 0;
+    std::size_t students = 0;
+    double seconds = 0;
+    std::string error;                // set when nothing was imported
+
+    double rowsPerSecond() const { return seconds > 0 ? rows / seconds : 0; }
+};
+
+// Streams "student,course,marks,credit" rows and appends them to each
+// student's file, grouped so every file is opened once per flush.
+// Each flush also commits the students' new CGPA totals to the ledger. A
+// file that cannot be appended to is cut back to its previous length and
+// its rows are counted as failed. Nothing is imported if logged grade
+// changes cannot be folded into the files first.
+ImportStats importGrades(std::istream& in, std::size_t flushBytes = 64u << 20);
+
+#endif
@@ -1,15 +1,55 @@
 #include "cadmin.h"
 #include "filemanager.h"
 #include "grades.h"
+#include "cgpaledger.h"
+#include "gradelog.h"
+#include "cohortreport.h"
+#include "transcripts.h"
+#include "archive.h"
+#include "userdirectory.h"
 #include "win.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <string>
+#include <iomanip>
+#include <filesystem>
 
 using namespace std;
 
+namespace {
+    const char* backupPath = "full_backup.zip";
+
+    // users.csv, grade_scale.csv and every student's grade file that exists.
+    vector<string> backupFiles() {
+        vector<string> files;
+        error_code ec;
+        for (const char* name : {"users.csv", "grade_scale.csv"}) {
+            if (filesystem::exists(name, ec)) files.push_back(name);
+        }
+        for (const auto& user : userDirectory().all()) {
+            string file = user.username + ".csv";
+            if (user.role == "student" && filesystem::exists(file, ec)) files.push_back(file);
+        }
+        return files;
+    }
+
+    // Only plain "<name>.csv" entries are restored, so an archive cannot
+    // write outside the data directory.
+    bool restorable(const string& name) {
+        return name.size() > 4 && name.compare(name.size() - 4, 4, ".csv") == 0 && name[0] != '.' &&
+               name.find_first_of("/\\:") == string::npos;
+    }
+
+    void printArchiveStats(const ArchiveStats& stats) {
+        cout << fixed << setprecision(1) << stats.files << " files, " << stats.bytes / 1048576.0 << " MB data, "
+             << stats.archiveBytes / 1048576.0 << " MB archive\n"
+             << "Wall time: " << setprecision(2) << stats.seconds << "s ("
+             << setprecision(1) << stats.bytesPerSecond() / 1048576.0 << " MB/s)\n";
+    }
+}
+
 Admin::Admin(const string& u, const string& p)
     : User(u, p) {}
 
@@ -18,13 +58,17 @@ void Admin::showDashboard() {
     do {
         printHeader("ADMIN DASHBOARD");
         cout << "1. Configure Grade Scale\n2. Edit Grades\n"
-             << "3. Export All Data\n4. Logout\nChoice: ";
+             << "3. Export All Data\n4. Cohort CGPA Report\n5. Restore From Backup\n"
+             << "6. Batch Transcripts\n7. Logout\nChoice: ";
         cin >> choice;
 
         if (choice == 1) configureGradeScale();
         else if (choice == 2) editGrades();
         else if (choice == 3) exportAllData();
-    } while (choice != 4);
+        else if (choice == 4) cohortReport();
+        else if (choice == 5) restoreAllData();
+        else if (choice == 6) batchTranscripts();
+    } while (choice != 7);
 }
 
 void Admin::configureGradeScale() {
@@ -40,6 +84,8 @@ void Admin::configureGradeScale() {
             if (line == "done") break;
             file << line << "\n";
         }
+        file.close();
+        invalidateGradeScale();
         cout << "Grade scale updated!\n";
     } else {
         cout << "Error saving grade scale!\n";
@@ -53,41 +99,33 @@ void Admin::editGrades() {
     cout << "Enter student username: ";
     cin >> student;
 
-    vector<Course> courses;
-    ifstream in(student + ".csv");
-    if (in) {
-        string line;
-        while (getline(in, line)) {
-            Course c;
-            stringstream ss(line);
-            getline(ss, c.name, ',');
-            ss >> c.marks; ss.ignore();
-            ss >> c.credit; ss.ignore();
-            getline(ss, c.grade);
-            courses.push_back(c);
-        }
-    }
+    vector<Course> courses = loadCourses(student);
 
     cout << "\nCourses:\n";
     for (size_t i = 0; i < courses.size(); i++) {
         cout << i + 1 << ". " << courses[i].name << " - "
-             << courses[i].grade << endl;
+             << gradeName(courses[i].grade) << endl;
     }
 
     cout << "\nEnter course number to edit: ";
     int choice;
     cin >> choice;
     if (choice > 0 && choice <= static_cast<int>(courses.size())) {
+        Course& course = courses[choice - 1];
+        CgpaLedger& ledger = cgpaLedger();
+        CgpaTotals totals = ledger.totals(student);
+        totals.remove(course.grade, course.credit);
         cout << "New marks: ";
-        cin >> courses[choice - 1].marks;
-        courses[choice - 1].grade = calculateGrade(courses[choice - 1].marks);
+        cin >> course.marks;
+        course.grade = calculateGrade(course.marks);
+        totals.add(course.grade, course.credit);
 
-        ofstream out(student + ".csv");
-        for (const auto& c : courses) {
-            out << c.name << "," << c.marks << ","
-                << c.credit << "," << c.grade << "\n";
+        if (gradeLog().setRow(student, choice - 1, course)) {
+            ledger.commit(student, totals);
+            cout << "Grade updated!\n";
+        } else {
+            cout << "Error saving grade!\n";
         }
-        cout << "Grade updated!\n";
     } else {
         cout << "Invalid selection!\n";
     }
@@ -97,12 +135,99 @@ void Admin::editGrades() {
 
 void Admin::exportAllData() {
     printHeader("EXPORT ALL DATA");
-    ofstream backup("full_backup.zip");
-    if (backup) {
-        cout << "All data exported to full_backup.zip\n";
+    if (!gradeLog().checkpoint()) {
+        cout << "Error creating backup: logged grade changes could not be written to the grade files\n";
+        cin.ignore();
+        cin.get();
+        return;
+    }
+    vector<string> files = backupFiles();
+    ThreadPool& pool = threadPool();
+    cout << "Compressing " << files.size() << " files on " << pool.size() << " threads...\n";
+
+    ArchiveStats stats = writeArchive(backupPath, files, pool, [](size_t done, size_t total) {
+        cout << "\rProgress: " << done << "/" << total << " files" << flush;
+    });
+
+    cout << "\n";
+    if (stats.error.empty()) {
+        cout << "All data exported to " << backupPath << "\n";
+        printArchiveStats(stats);
+    } else {
+        cout << "Error creating backup: " << stats.error << "\n";
+    }
+    cin.ignore();
+    cin.get();
+}
+
+void Admin::restoreAllData() {
+    printHeader("RESTORE FROM BACKUP");
+    cout << "Replace users, grade scale and grade files with the contents of "
+         << backupPath << "? (y/n): ";
+    char confirm;
+    cin >> confirm;
+    if (confirm != 'y' && confirm != 'Y') {
+        cout << "Restore cancelled.\n";
+    } else if (!gradeLog().checkpoint()) {
+        // The restored files would be overwritten by the logged rows later.
+        cout << "Restore failed, nothing was changed: logged grade changes could not be written out\n";
     } else {
-        cout << "Error creating backup!\n";
+        ArchiveStats stats = extractArchive(backupPath, threadPool(), restorable, [](size_t done, size_t total) {
+            cout << "\rProgress: " << done << "/" << total << " files" << flush;
+        });
+        cout << "\n";
+        if (stats.error.empty()) {
+            userDirectory().reload();
+            invalidateGradeScale();
+            cout << "Restored from " << backupPath << "\n";
+            printArchiveStats(stats);
+            if (stats.skipped) cout << stats.skipped << " entries skipped\n";
+        } else if (stats.partial) {
+            cout << "Restore failed part way and some files could not be put back: " << stats.error << "\n";
+            cout << "Check the data files; the previous versions are left as <name>.original\n";
+        } else {
+            cout << "Restore failed, nothing was changed: " << stats.error << "\n";
+        }
     }
     cin.ignore();
     cin.get();
 }
+
+void Admin::cohortReport() {
+    printHeader("COHORT CGPA REPORT");
+    ThreadPool& pool = threadPool();
+    cout << "Computing CGPAs on " << pool.size() << " threads...\n";
+
+    CohortReport report = buildCohortReport(pool, [](size_t done, size_t total) {
+        cout << "\rProgress: " << done << "/" << total << " students" << flush;
+    });
+
+    cout << "\n";
+    if (writeCohortReport("cgpa_report.csv", report)) {
+        double perSecond = report.seconds > 0 ? report.entries.size() / report.seconds : 0;
+        cout << "Report for " << report.entries.size() << " students written to cgpa_report.csv\n"
+             << "Wall time: " << fixed << setprecision(2) << report.seconds << "s ("
+             << static_cast<long long>(perSecond) << " students/sec)\n";
+    } else {
+        cout << "Error writing cgpa_report.csv!\n";
+    }
+    cin.ignore();
+    cin.get();
+}
+
+void Admin::batchTranscripts() {
+    printHeader("BATCH TRANSCRIPTS");
+    ThreadPool& pool = threadPool();
+    cout << "Rendering transcripts on " << pool.size() << " threads...\n";
+
+    TranscriptStats stats = writeTranscripts("transcripts", pool, [](size_t done, size_t total) {
+        cout << "\rProgress: " << done << "/" << total << " students" << flush;
+    });
+
+    cout << "\n" << stats.students << " transcripts (CSV and HTML) written to transcripts/\n"
+         << fixed << setprecision(1) << stats.bytes / 1048576.0 << " MB, wall time: " << setprecision(2)
+         << stats.seconds << "s (" << static_cast<long long>(stats.transcriptsPerSecond()) << " transcripts/sec)\n";
+    if (stats.failed) cout << stats.failed << " students could not be written!\n";
+    cin.ignore();
+    cin.get();
+}
@@ -12,6 +12,9 @@ public:
     void configureGradeScale();
     void editGrades();
     void exportAllData();
+    void restoreAllData();
+    void cohortReport();
+    void batchTranscripts();
 };
 
 #endif
\ No newline at end of file
@@ -1,12 +1,15 @@
 #include "cfaculty.h"
 #include "filemanager.h"
 #include "grades.h"
+#include "cgpaledger.h"
+#include "gradelog.h"
+#include "bulkimport.h"
 #include "win.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <string>
 #include <limits>
+#include <iomanip>
 
 using namespace std;
 
@@ -42,10 +45,12 @@ void Faculty::enterGrades() {
 
     c.grade = calculateGrade(c.marks);
 
-    ofstream file(studentName + ".csv", ios::app);
-    if (file) {
-        file << c.name << "," << c.marks << ","
-             << c.credit << "," << c.grade << "\n";
+    // totals.courses counts the student's rows, so this one goes after them.
+    CgpaLedger& ledger = cgpaLedger();
+    CgpaTotals totals = ledger.totals(studentName);
+    if (gradeLog().setRow(studentName, totals.courses, c)) {
+        totals.add(c.grade, c.credit);
+        ledger.commit(studentName, totals);
         cout << "\nGrade added successfully!\n";
     } else {
         cout << "\nError saving grade!\n";
@@ -61,25 +66,22 @@ void Faculty::bulkUpload() {
     cout << "CSV filename: ";
     cin >> filename;
 
-    ifstream file(filename);
+    ifstream file(filename, ios::binary);
     if (file) {
-        string line;
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string student, course;
-            int marks, credit;
-
-            getline(ss, student, ',');
-            getline(ss, course, ',');
-            ss >> marks;
-            ss.ignore();
-            ss >> credit;
-
-            ofstream out(student + ".csv", ios::app);
-            out << course << "," << marks << ","
-                << credit << "," << calculateGrade(marks) << "\n";
+        ImportStats stats = importGrades(file);
+        if (!stats.error.empty()) {
+            cout << "\nBulk upload failed, nothing was imported: " << stats.error << "\n";
+        } else {
+            cout << "\nBulk upload completed!\n"
+                 << stats.rows << " rows for " << stats.students << " students in "
+                 << fixed << setprecision(2) << stats.seconds << "s ("
+                 << static_cast<long long>(stats.rowsPerSecond()) << " rows/sec)\n";
+            if (stats.skipped) cout << stats.skipped << " malformed rows skipped\n";
+            if (stats.failed) {
+                cout << stats.failed << " rows for " << stats.failedStudents
+                     << " students NOT imported: their grade files could not be written\n";
+            }
         }
-        cout << "\nBulk upload completed!\n";
     } else {
         cout << "\nFile not found!\n";
     }
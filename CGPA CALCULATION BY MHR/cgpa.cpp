@@ -1,14 +1,12 @@
 #include "cgpa.h"
 #include "grades.h"
 
-float calculateCGPA(const std::vector<Course>& courses) {
-    float totalPoints = 0;
-    int totalCredits = 0;
-    auto gradeValues = loadGradePoints();
+CgpaTotals totalsOf(const std::vector<Course>& courses) {
+    CgpaTotals totals;
+    for (const auto& course : courses) totals.add(course.grade, course.credit);
+    return totals;
+}
 
-    for (const auto& course : courses) {
-        totalPoints += gradeValues[course.grade] * course.credit;
-        totalCredits += course.credit;
-    }
-    return totalCredits ? totalPoints / totalCredits : 0;
+float calculateCGPA(const std::vector<Course>& courses) {
+    return totalsOf(courses).cgpa();
 }
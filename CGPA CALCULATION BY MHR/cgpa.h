@@ -2,8 +2,37 @@
 #define CGPA_H
 
 #include "grades.h"
+#include <cstdint>
 #include <vector>
 
+// Running totals behind a CGPA. Every grade point is a multiple of 0.25, so
+// points are kept as whole quarter points and adding or removing a course
+// never accumulates rounding error.
+struct CgpaTotals {
+    std::int64_t quarterPoints = 0;
+    int credits = 0;
+    int courses = 0;
+
+    void add(Grade grade, int credit) {
+        quarterPoints += static_cast<std::int64_t>(gradePoint(grade) * 4) * credit;
+        credits += credit;
+        courses++;
+    }
+    void remove(Grade grade, int credit) {
+        quarterPoints -= static_cast<std::int64_t>(gradePoint(grade) * 4) * credit;
+        credits -= credit;
+        courses--;
+    }
+    CgpaTotals& operator+=(const CgpaTotals& other) {
+        quarterPoints += other.quarterPoints;
+        credits += other.credits;
+        courses += other.courses;
+        return *this;
+    }
+    float cgpa() const { return credits ? static_cast<float>(quarterPoints / (4.0 * credits)) : 0; }
+};
+
+CgpaTotals totalsOf(const std::vector<Course>& courses);
 float calculateCGPA(const std::vector<Course>& courses);
 
-#endif // CGPA_H
\ No newline at end of file
+#endif // CGPA_H
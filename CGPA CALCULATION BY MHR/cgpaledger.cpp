@@ -0,0 +1,117 @@
+#include "cgpaledger.h"
+#include "filemanager.h"
+#include <charconv>
+#include <filesystem>
+#include <string_view>
+
+namespace {
+    const char* const journalPath = "cgpa_totals.log";
+
+    template <typename T>
+    bool readField(std::string_view& rest, T& value) {
+        std::size_t comma = rest.find(',');
+        std::string_view field = rest.substr(0, comma);
+        auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+        rest.remove_prefix(comma == std::string_view::npos ? rest.size() : comma + 1);
+        return result.ec == std::errc() && result.ptr == field.data() + field.size();
+    }
+}
+
+CgpaLedger::Stamp CgpaLedger::stampOf(const std::string& username) {
+    Stamp stamp;
+    std::error_code ec;
+    std::string file = username + ".csv";
+    auto size = std::filesystem::file_size(file, ec);
+    if (ec) return stamp;
+    auto mtime = std::filesystem::last_write_time(file, ec);
+    if (ec) return stamp;
+    stamp.size = static_cast<std::int64_t>(size);
+    stamp.mtime = static_cast<std::int64_t>(mtime.time_since_epoch().count());
+    return stamp;
+}
+
+// Replays the journal, then compacts it to one line per student once stale
+// lines outnumber live ones, so it stays proportional to the cohort.
+void CgpaLedger::load() {
+    loaded = true;
+    {
+        std::ifstream in(journalPath);
+        std::string line;
+        while (std::getline(in, line)) {
+            journalLines++;
+            std::string_view rest = line;
+            std::size_t comma = rest.find(',');
+            if (comma == 0 || comma == std::string_view::npos) continue;
+            std::string username(rest.substr(0, comma));
+            rest.remove_prefix(comma + 1);
+            Entry e;
+            if (readField(rest, e.totals.quarterPoints) && readField(rest, e.totals.credits) &&
+                readField(rest, e.totals.courses) && readField(rest, e.stamp.size) &&
+                readField(rest, e.stamp.mtime)) {
+                entries[std::move(username)] = e;
+            }
+        }
+    }
+
+    if (journalLines > 2 * entries.size() + 1024) {
+        std::string tmp = std::string(journalPath) + ".tmp";
+        std::ofstream out(tmp, std::ios::trunc);
+        for (const auto& [username, e] : entries) {
+            out << username << ',' << e.totals.quarterPoints << ',' << e.totals.credits << ','
+                << e.totals.courses << ',' << e.stamp.size << ',' << e.stamp.mtime << '\n';
+        }
+        out.close();
+        std::error_code ec;
+        if (out) std::filesystem::rename(tmp, journalPath, ec);
+        else std::filesystem::remove(tmp, ec);
+        if (!ec && out) journalLines = entries.size();
+    }
+    journal.open(journalPath, std::ios::app);
+}
+
+void CgpaLedger::record(const std::string& username, const Entry& e) {
+    entries[username] = e;
+    journal << username << ',' << e.totals.quarterPoints << ',' << e.totals.credits << ','
+            << e.totals.courses << ',' << e.stamp.size << ',' << e.stamp.mtime << '\n';
+    journalLines++;
+}
+
+// The stamp is taken before the file is read: if the file changes in
+// between, the entry carries the older stamp and is rebuilt on the next call.
+CgpaTotals CgpaLedger::totals(const std::string& username) {
+    Stamp stamp = stampOf(username);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!loaded) load();
+        auto it = entries.find(username);
+        if (it != entries.end() && it->second.stamp == stamp) return it->second.totals;
+    }
+
+    // Rebuilt outside the lock so pool workers read their files in parallel.
+    Entry e{totalsOf(loadCourses(username)), stamp};
+    std::lock_guard<std::mutex> lock(mutex);
+    record(username, e);
+    return e.totals;
+}
+
+void CgpaLedger::commit(const std::string& username, const CgpaTotals& updated) {
+    Entry e{updated, stampOf(username)};
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!loaded) load();
+    record(username, e);
+    journal.flush();
+}
+
+void CgpaLedger::folded(const std::string& username, const Stamp& before) {
+    Stamp after = stampOf(username);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!loaded) load();
+    auto it = entries.find(username);
+    if (it == entries.end() || !(it->second.stamp == before) || after == before) return;
+    record(username, Entry{it->second.totals, after});
+}
+
+CgpaLedger& cgpaLedger() {
+    static CgpaLedger ledger;
+    return ledger;
+}
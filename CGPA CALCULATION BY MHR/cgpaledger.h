@@ -0,0 +1,59 @@
+#ifndef CGPA_LEDGER
+#define CGPA_LEDGER
+
+#include "cgpa.h"
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Per-student CGPA totals kept in step with the <username>.csv course files,
+// so reading a CGPA is a lookup rather than a parse of the student's file.
+//
+// Entries persist in cgpa_totals.log, one line per change
+// (username,quarterPoints,credits,courses,size,mtime); the last line for a
+// student wins. Each entry is stamped with the size and write time of the
+// course file it was taken from, so a file changed some other way (restore,
+// hand edit) is re-read the next time it is asked for.
+class CgpaLedger {
+public:
+    // Totals for <username>.csv as it is now. Safe to call from pool workers.
+    CgpaTotals totals(const std::string& username);
+
+    // Records the totals of <username>.csv just after the caller changed it,
+    // directly or through the grade log: what totals() returned before the
+    // change, plus the change.
+    void commit(const std::string& username, const CgpaTotals& updated);
+
+    struct Stamp {
+        std::int64_t size = -1;  // -1: no course file
+        std::int64_t mtime = 0;
+        bool operator==(const Stamp& o) const { return size == o.size && mtime == o.mtime; }
+    };
+    static Stamp stampOf(const std::string& username);
+
+    // The grade log's checkpoint rewrote <username>.csv (stamped `before`)
+    // with rows totals() already saw through the overlay. An entry that was
+    // current for the old file is re-stamped rather than rebuilt.
+    void folded(const std::string& username, const Stamp& before);
+
+private:
+    struct Entry {
+        CgpaTotals totals;
+        Stamp stamp;
+    };
+
+    void load();
+    void record(const std::string& username, const Entry& entry);
+
+    std::mutex mutex;
+    bool loaded = false;
+    std::unordered_map<std::string, Entry> entries;
+    std::ofstream journal;
+    std::size_t journalLines = 0;
+};
+
+CgpaLedger& cgpaLedger();
+
+#endif
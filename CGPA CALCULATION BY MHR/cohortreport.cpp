@@ -0,0 +1,46 @@
+#include "cohortreport.h"
+#include "userdirectory.h"
+#include "cgpaledger.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+CohortReport buildCohortReport(ThreadPool& pool,
+                               const std::function<void(std::size_t, std::size_t)>& progress) {
+    auto start = std::chrono::steady_clock::now();
+    CohortReport report;
+
+    for (const auto& user : userDirectory().all()) {
+        if (user.role == "student") report.entries.push_back({user.username});
+    }
+
+    // Each worker only touches its own entry; the ledger locks internally and
+    // only re-reads course files that changed since their totals were taken.
+    std::size_t total = report.entries.size();
+    pool.parallelFor(total, [&](std::size_t i) {
+        CohortEntry& entry = report.entries[i];
+        CgpaTotals totals = cgpaLedger().totals(entry.username);
+        entry.cgpa = totals.cgpa();
+        entry.courses = totals.courses;
+        entry.credits = totals.credits;
+    }, progress ? [&](std::size_t done) { progress(done, total); } : std::function<void(std::size_t)>());
+
+    std::sort(report.entries.begin(), report.entries.end(), [](const CohortEntry& a, const CohortEntry& b) {
+        if (a.cgpa != b.cgpa) return a.cgpa > b.cgpa;
+        return a.username < b.username;
+    });
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+bool writeCohortReport(const std::string& path, const CohortReport& report) {
+    std::ofstream file(path);
+    if (!file) return false;
+    file << "rank,username,cgpa,courses,credits\n" << std::fixed << std::setprecision(2);
+    for (std::size_t i = 0; i < report.entries.size(); i++) {
+        const CohortEntry& e = report.entries[i];
+        file << i + 1 << "," << e.username << "," << e.cgpa << "," << e.courses << "," << e.credits << "\n";
+    }
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,28 @@
+#ifndef COHORT_REPORT
+#define COHORT_REPORT
+
+#include "threadpool.h"
+#include <string>
+#include <vector>
+#include <functional>
+
+struct CohortEntry {
+    std::string username;
+    float cgpa = 0;
+    int courses = 0;
+    int credits = 0;
+};
+
+struct CohortReport {
+    std::vector<CohortEntry> entries;  // highest CGPA first, ties by username
+    double seconds = 0;
+};
+
+// Reads every student's CGPA totals from the ledger on the pool; course
+// files are only parsed for students whose totals are missing or stale.
+CohortReport buildCohortReport(ThreadPool& pool,
+                               const std::function<void(std::size_t done, std::size_t total)>& progress = nullptr);
+
+bool writeCohortReport(const std::string& path, const CohortReport& report);
+
+#endif
@@ -1,6 +1,7 @@
 #include "cstudent.h"
 #include "filemanager.h"
-#include "cgpa.h"
+#include "cgpaledger.h"
+#include "transcripts.h"
 #include "win.h"
 #include <iomanip>
 #include <iostream>
@@ -30,19 +31,17 @@ void Student::showDashboard() {
                 std::cout << std::setw(25) << course.name
                           << std::setw(10) << course.marks
                           << std::setw(10) << course.credit
-                          << course.grade << "\n";
+                          << gradeName(course.grade) << "\n";
             }
             std::cout << "\nCGPA: " << std::fixed << std::setprecision(2)
-                      << calculateCGPA(courses) << "\n";
+                      << cgpaLedger().totals(username).cgpa() << "\n";
             std::cin.ignore();
             std::cin.get();
         } else if (choice == 2) {
+            std::string csv;
+            renderTranscriptCsv(courses, csv);
             std::ofstream file(username + "_transcript.csv");
-            file << "Course,Marks,Credit,Grade\n";
-            for (const auto& course : courses) {
-                file << course.name << "," << course.marks << ","
-                     << course.credit << "," << course.grade << "\n";
-            }
+            file.write(csv.data(), csv.size());
             std::cout << "Transcript exported successfully!\n";
             std::cin.ignore();
             std::cin.get();
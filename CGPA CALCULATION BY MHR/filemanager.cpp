@@ -1,46 +1,107 @@
 #include "filemanager.h"
+#include "userdirectory.h"
+#include "gradelog.h"
 #include <fstream>
-#include <sstream>
+#include <filesystem>
+#include <string_view>
+#include <charconv>
+#include <cctype>
 
-std::vector<Course> loadCourses(const std::string& username) {
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    // Same rules as `stream >> value; stream.ignore();`: leading blanks and a
+    // sign are accepted, one separator after the number is skipped, and a
+    // failed read yields 0 and fails every field after it.
+    bool readInt(std::string_view& rest, int& value) {
+        std::size_t i = 0;
+        while (i < rest.size() && std::isspace(static_cast<unsigned char>(rest[i]))) i++;
+        if (i < rest.size() && rest[i] == '+') i++;
+        auto result = std::from_chars(rest.data() + i, rest.data() + rest.size(), value);
+        if (result.ec != std::errc()) {
+            value = 0;
+            return false;
+        }
+        rest.remove_prefix(result.ptr - rest.data());
+        if (!rest.empty()) rest.remove_prefix(1);
+        return true;
+    }
+}
+
+// Parsed in place rather than through a stringstream per line: building a
+// stream takes a reference on the shared global locale, which serialises
+// threads loading many files at once (cohort report).
+std::vector<Course> loadCourseFile(const std::string& username) {
     std::vector<Course> courses;
     std::ifstream file(username + ".csv");
     if (file) {
         std::string line;
         while (std::getline(file, line)) {
             Course c;
-            std::stringstream ss(line);
-            std::getline(ss, c.name, ',');
-            ss >> c.marks; ss.ignore();
-            ss >> c.credit; ss.ignore();
-            std::getline(ss, c.grade);
+            std::string_view rest = line;
+            std::size_t comma = rest.find(',');
+            c.name = rest.substr(0, comma);
+            rest.remove_prefix(comma == std::string_view::npos ? rest.size() : comma + 1);
+
+            bool ok = readInt(rest, c.marks);
+            if (ok) ok = readInt(rest, c.credit);
+            else c.credit = 0;
+            c.grade = ok ? parseGrade(std::string(rest)) : Grade::Unknown;
             courses.push_back(c);
         }
     }
     return courses;
 }
 
-void saveCourses(const std::string& username, const std::vector<Course>& courses) {
-    std::ofstream file(username + ".csv");
+std::vector<Course> loadCourses(const std::string& username) {
+    std::vector<Course> courses = loadCourseFile(username);
+    gradeLog().overlay(username, courses);
+    return courses;
+}
+
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool saveCourses(const std::string& username, const std::vector<Course>& courses) {
+    std::string data;
     for (const auto& course : courses) {
-        file << course.name << "," << course.marks << ","
-             << course.credit << "," << course.grade << "\n";
+        data += course.name;
+        data += ',';
+        data += std::to_string(course.marks);
+        data += ',';
+        data += std::to_string(course.credit);
+        data += ',';
+        data += gradeName(course.grade);
+        data += '\n';
     }
+
+    std::string path = username + ".csv", tmp = path + ".tmp";
+    std::FILE* out = std::fopen(tmp.c_str(), "wb");
+    if (!out) return false;
+    bool ok = std::fwrite(data.data(), 1, data.size(), out) == data.size();
+    ok = syncFile(out) && ok;
+    ok = std::fclose(out) == 0 && ok;
+
+    std::error_code ec;
+    if (ok) std::filesystem::rename(tmp, path, ec);
+    else std::filesystem::remove(tmp, ec);
+    return ok && !ec;
 }
 
 bool userExists(const std::string& username) {
-    std::ifstream check("users.csv");
-    std::string line;
-    while (std::getline(check, line)) {
-        std::stringstream ss(line);
-        std::string storedUser;
-        std::getline(ss, storedUser, ',');
-        if (storedUser == username) return true;
-    }
-    return false;
+    return userDirectory().exists(username);
 }
 
 void saveUser(const std::string& username, const std::string& password, const std::string& role) {
-    std::ofstream file("users.csv", std::ios::app);
-    file << username << "," << password << "," << role << "\n";
+    userDirectory().add(username, password, role);
 }
\ No newline at end of file
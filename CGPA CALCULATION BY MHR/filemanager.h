@@ -2,11 +2,17 @@
 #define FILE_MANAGER
 
 #include "grades.h"
+#include <cstdio>
 #include <vector>
 #include <string>
 
+// <username>.csv with any logged changes not yet checkpointed laid over it.
 std::vector<Course> loadCourses(const std::string& username);
-void saveCourses(const std::string& username, const std::vector<Course>& courses);
+// <username>.csv exactly as it is on disk.
+std::vector<Course> loadCourseFile(const std::string& username);
+// Replaces <username>.csv: written to a temporary, synced and renamed over it.
+bool saveCourses(const std::string& username, const std::vector<Course>& courses);
+bool syncFile(std::FILE* file);
 bool userExists(const std::string& username);
 void saveUser(const std::string& username, const std::string& password, const std::string& role);
 
@@ -0,0 +1,274 @@
+#include "gradelog.h"
+#include "filemanager.h"
+#include "cgpaledger.h"
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <iterator>
+#include <string_view>
+
+namespace {
+    const char* const logPath = "grades.wal";
+
+    std::uint64_t checksum(std::string_view s) {
+        std::uint64_t h = 14695981039346656037ull;
+        for (unsigned char c : s) {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    // <checksum>\t<student>\t<row>\t<marks>\t<credit>\t<grade>\t<course name>\n
+    // The checksum (16 hex digits) covers everything after the first tab, so
+    // a record torn by a crash is recognised and dropped with the rest of the
+    // tail.
+    void encode(std::string& out, const std::string& student, std::size_t row, const Course& c) {
+        std::string body = student + '\t' + std::to_string(row) + '\t' + std::to_string(c.marks) + '\t' +
+                           std::to_string(c.credit) + '\t' + gradeName(c.grade) + '\t' + c.name;
+        char sum[17];
+        std::uint64_t h = checksum(body);
+        for (int i = 15; i >= 0; i--, h >>= 4) sum[i] = "0123456789abcdef"[h & 15];
+        sum[16] = '\t';
+        out.append(sum, 17);
+        out += body;
+        out += '\n';
+    }
+
+    bool decode(std::string_view line, std::string& student, std::size_t& row, Course& c) {
+        if (line.size() < 17 || line[16] != '\t') return false;
+        std::uint64_t sum = 0;
+        auto parsed = std::from_chars(line.data(), line.data() + 16, sum, 16);
+        std::string_view body = line.substr(17);
+        if (parsed.ptr != line.data() + 16 || sum != checksum(body)) return false;
+
+        std::string_view fields[6];
+        for (int i = 0; i < 5; i++) {
+            std::size_t tab = body.find('\t');
+            if (tab == std::string_view::npos) return false;
+            fields[i] = body.substr(0, tab);
+            body.remove_prefix(tab + 1);
+        }
+        fields[5] = body;
+        auto number = [](std::string_view f, auto& value) {
+            auto r = std::from_chars(f.data(), f.data() + f.size(), value);
+            return r.ec == std::errc() && r.ptr == f.data() + f.size();
+        };
+        if (!number(fields[1], row) || !number(fields[2], c.marks) || !number(fields[3], c.credit)) return false;
+        student = std::string(fields[0]);
+        c.grade = parseGrade(std::string(fields[4]));
+        c.name = std::string(fields[5]);
+        return true;
+    }
+
+    void place(std::vector<Course>& courses, std::size_t row, const Course& c) {
+        if (row < courses.size()) courses[row] = c;
+        else courses.push_back(c);
+    }
+}
+
+GradeLog& gradeLog() {
+    static GradeLog log;
+    return log;
+}
+
+GradeLog::GradeLog() {
+    // checkpoint() reports folded students to the ledger, including the
+    // final one in ~GradeLog; constructing it first means it is destroyed
+    // after this log.
+    cgpaLedger();
+    replay();
+    committer = std::thread(&GradeLog::commitLoop, this);
+    checkpointer = std::thread(&GradeLog::checkpointLoop, this);
+}
+
+GradeLog::~GradeLog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    commitWake.notify_all();
+    checkpointWake.notify_all();
+    checkpointer.join();
+    committer.join();
+    checkpoint();
+    if (log) std::fclose(log);
+}
+
+// Reads back what a previous run left in the log, cuts off a torn tail so
+// new records are not appended after it, and folds the rest into the files.
+void GradeLog::replay() {
+    std::string data;
+    if (std::FILE* in = std::fopen(logPath, "rb")) {
+        char buf[1 << 16];
+        std::size_t n;
+        while ((n = std::fread(buf, 1, sizeof buf, in)) > 0) data.append(buf, n);
+        std::fclose(in);
+    }
+
+    std::size_t valid = 0;
+    std::string student;
+    while (valid < data.size()) {
+        std::size_t eol = data.find('\n', valid);
+        Record r;
+        if (eol == std::string::npos ||
+            !decode(std::string_view(data).substr(valid, eol - valid), student, r.row, r.course)) {
+            break;
+        }
+        r.seq = ++lastSeq;
+        pending[student].push_back(std::move(r));
+        valid = eol + 1;
+    }
+    settledSeq = lastSeq;
+    logBytes = valid;
+
+    std::error_code ec;
+    if (valid < data.size()) std::filesystem::resize_file(logPath, valid, ec);
+    log = std::fopen(logPath, "ab");
+    if (!pending.empty()) checkpoint();
+}
+
+bool GradeLog::failed(std::uint64_t seq) const {
+    for (const auto& [first, last] : failedBatches) {
+        if (seq >= first && seq <= last) return true;
+    }
+    return false;
+}
+
+bool GradeLog::setRow(const std::string& student, std::size_t row, const Course& course) {
+    std::unique_lock<std::mutex> lock(mutex);
+    std::uint64_t seq = ++lastSeq;
+    encode(queued, student, row, course);
+    pending[student].push_back({seq, row, course});
+    commitWake.notify_one();
+    settledWake.wait(lock, [&] { return settled(seq); });
+    return !failed(seq);
+}
+
+void GradeLog::overlay(const std::string& student, std::vector<Course>& courses) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pending.find(student);
+    if (it == pending.end()) return;
+    for (const Record& r : it->second) place(courses, r.row, r.course);
+}
+
+// Everything queued while the previous batch was being synced goes out as
+// the next batch, with one write and one fsync.
+void GradeLog::commitLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        commitWake.wait(lock, [&] { return stopping || !queued.empty(); });
+        if (queued.empty()) return;
+
+        std::string batch;
+        batch.swap(queued);
+        std::uint64_t first = settledSeq + 1, last = lastSeq;
+        lock.unlock();
+
+        bool ok;
+        {
+            std::lock_guard<std::mutex> guard(fileMutex);
+            ok = log && std::fwrite(batch.data(), 1, batch.size(), log) == batch.size() && syncFile(log);
+            if (ok) {
+                logBytes += batch.size();
+            } else if (log) {
+                // Drop a partial write so later records are not stranded behind it.
+                std::error_code ec;
+                std::clearerr(log);
+                std::filesystem::resize_file(logPath, logBytes, ec);
+            }
+        }
+
+        lock.lock();
+        if (ok) {
+            counters.records += last - first + 1;
+            counters.syncs++;
+            sinceCheckpoint += last - first + 1;
+        } else {
+            failedBatches.emplace_back(first, last);
+            for (auto it = pending.begin(); it != pending.end();) {
+                auto& records = it->second;
+                records.erase(std::remove_if(records.begin(), records.end(),
+                                             [&](const Record& r) { return r.seq >= first && r.seq <= last; }),
+                              records.end());
+                it = records.empty() ? pending.erase(it) : std::next(it);
+            }
+        }
+        settledSeq = last;
+        settledWake.notify_all();
+        if (sinceCheckpoint >= checkpointRecords) checkpointWake.notify_one();
+    }
+}
+
+void GradeLog::checkpointLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        checkpointWake.wait_for(lock, checkpointInterval,
+                                [&] { return stopping || sinceCheckpoint >= checkpointRecords; });
+        if (stopping || pending.empty()) continue;
+        lock.unlock();
+        checkpoint();
+        lock.lock();
+    }
+}
+
+bool GradeLog::checkpoint() {
+    std::lock_guard<std::mutex> guard(checkpointMutex);
+
+    // Only durable records are folded; ones still waiting for the committer
+    // stay pending for the next checkpoint.
+    std::vector<std::pair<std::string, std::vector<Record>>> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sinceCheckpoint = 0;
+        for (const auto& [student, records] : pending) {
+            std::vector<Record> durable;
+            for (const Record& r : records) {
+                if (settled(r.seq)) durable.push_back(r);
+            }
+            if (!durable.empty()) batch.emplace_back(student, std::move(durable));
+        }
+    }
+
+    // Readers keep laying the records over the files while this runs; since
+    // records set whole rows, seeing one both in a file and in the overlay
+    // gives the same result.
+    bool ok = true;
+    for (auto& [student, records] : batch) {
+        CgpaLedger::Stamp before = CgpaLedger::stampOf(student);
+        std::vector<Course> courses = loadCourseFile(student);
+        for (const Record& r : records) place(courses, r.row, r.course);
+        if (!saveCourses(student, courses)) {
+            ok = false;
+            records.clear();
+        } else {
+            cgpaLedger().folded(student, before);
+        }
+    }
+
+    std::lock_guard<std::mutex> file(fileMutex);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& [student, records] : batch) {
+        if (records.empty()) continue;
+        auto it = pending.find(student);
+        std::uint64_t folded = records.back().seq;
+        auto& list = it->second;
+        list.erase(list.begin(), std::find_if(list.begin(), list.end(),
+                                              [&](const Record& r) { return r.seq > folded; }));
+        if (list.empty()) pending.erase(it);
+    }
+    counters.checkpoints++;
+
+    // Empty the log only when every record in it has been folded.
+    if (pending.empty() && queued.empty() && settledSeq == lastSeq && logBytes > 0) {
+        std::error_code ec;
+        std::filesystem::resize_file(logPath, 0, ec);
+        if (!ec) logBytes = 0;
+    }
+    return ok;
+}
+
+GradeLogStats GradeLog::stats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
@@ -0,0 +1,93 @@
+#ifndef GRADE_LOG
+#define GRADE_LOG
+
+#include "grades.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct GradeLogStats {
+    std::uint64_t records = 0;      // records made durable since startup
+    std::uint64_t syncs = 0;        // fsyncs of grades.wal that carried them
+    std::uint64_t checkpoints = 0;
+};
+
+// Write-ahead log for the <username>.csv course files.
+//
+// Every grade change is one record in grades.wal: "row N of student S is now
+// C", where N equal to the current row count appends. Records set whole
+// rows, so replaying one that is already in the file changes nothing.
+// setRow() returns once its record is on disk. A committer thread writes and
+// fsyncs whatever has queued up while the previous sync was running, so
+// concurrent or back-to-back changes share one fsync (group commit).
+//
+// Logged rows are kept in memory and laid over the files by loadCourses()
+// until a checkpoint folds them in. The checkpoint thread runs one every
+// checkpointInterval, or as soon as the log holds checkpointRecords records.
+// Each folded file is replaced through saveCourses(), and the log is emptied
+// once nothing in it is still pending. Records left by a crash are replayed
+// the same way when the log is opened.
+class GradeLog {
+public:
+    GradeLog();
+    ~GradeLog();  // final checkpoint, then stops both threads
+
+    // Logs the new contents of one row and waits until the record is
+    // durable. False when the log could not be written; nothing changes then.
+    bool setRow(const std::string& student, std::size_t row, const Course& course);
+
+    // Applies logged rows that are not yet in <student>.csv.
+    void overlay(const std::string& student, std::vector<Course>& courses);
+
+    // Folds every durable record into the course files now. Call before the
+    // course files are read or replaced directly (backup, restore, bulk
+    // import). False if a file could not be written; its records stay logged.
+    bool checkpoint();
+
+    GradeLogStats stats();
+
+    static constexpr std::size_t checkpointRecords = 4096;
+    static constexpr std::chrono::seconds checkpointInterval{2};
+
+private:
+    struct Record {
+        std::uint64_t seq;
+        std::size_t row;
+        Course course;
+    };
+
+    void replay();
+    void commitLoop();
+    void checkpointLoop();
+    bool settled(std::uint64_t seq) const { return seq <= settledSeq; }
+    bool failed(std::uint64_t seq) const;
+
+    std::mutex mutex;
+    std::condition_variable commitWake, settledWake, checkpointWake;
+    std::unordered_map<std::string, std::vector<Record>> pending;  // logged, not yet folded
+    std::string queued;                    // encoded records waiting for the committer
+    std::uint64_t lastSeq = 0;             // last record handed to setRow
+    std::uint64_t settledSeq = 0;          // every record up to here is durable or failed
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> failedBatches;
+    std::size_t sinceCheckpoint = 0;       // records made durable since the last checkpoint began
+    std::uint64_t logBytes = 0;            // valid bytes in grades.wal
+    GradeLogStats counters;
+    bool stopping = false;
+
+    std::mutex fileMutex;                  // held while grades.wal is written or emptied
+    std::mutex checkpointMutex;            // one checkpoint at a time
+    std::FILE* log = nullptr;
+
+    std::thread committer, checkpointer;
+};
+
+GradeLog& gradeLog();
+
+#endif
@@ -1,6 +1,12 @@
 #include "grades.h"
 #include <fstream>
 #include <sstream>
+#include <filesystem>
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
 
 std::map<std::string, std::pair<int, int>> loadGradeScale() {
     std::map<std::string, std::pair<int, int>> scale;
@@ -26,20 +32,150 @@ std::map<std::string, std::pair<int, int>> loadGradeScale() {
     return scale;
 }
 
-std::map<std::string, float> loadGradePoints() {
-    return {
-        {"A+", 4.0}, {"A", 3.75}, {"A-", 3.5},
-        {"B+", 3.25}, {"B", 3.0}, {"B-", 2.75},
-        {"C+", 2.5}, {"C", 2.25}, {"D", 2.0}, {"F", 0.0}
+namespace {
+    // Grade text that is not one of the built-in names. Entries are never
+    // removed, and a deque keeps their addresses fixed, so gradeName() can
+    // hand out c_str() pointers. Course files are parsed on several threads
+    // (checkpoint, cohort report), hence the lock.
+    struct GradeNames {
+        std::mutex mutex;
+        std::deque<std::string> names;
+        std::unordered_map<std::string, std::uint16_t> codes;
     };
+
+    GradeNames& gradeNames() {
+        static GradeNames table;
+        return table;
+    }
+
+    constexpr std::uint16_t firstInterned = static_cast<std::uint16_t>(Grade::Unknown) + 1;
+
+    Grade internGrade(std::string_view grade) {
+        GradeNames& table = gradeNames();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        auto it = table.codes.find(std::string(grade));
+        if (it != table.codes.end()) return static_cast<Grade>(it->second);
+        if (table.names.size() >= 0xFFFFu - firstInterned) return Grade::Unknown;
+        std::uint16_t code = static_cast<std::uint16_t>(firstInterned + table.names.size());
+        table.names.emplace_back(grade);
+        table.codes.emplace(table.names.back(), code);
+        return static_cast<Grade>(code);
+    }
+}
+
+Grade parseGrade(const std::string& text) {
+    // A file saved with CRLF line ends leaves the '\r' on the last field.
+    std::string_view grade(text);
+    if (!grade.empty() && grade.back() == '\r') grade.remove_suffix(1);
+    if (grade.empty()) return Grade::Unknown;
+
+    Grade g = Grade::Unknown;
+    if (grade.size() <= 2) {
+        char mod = grade.size() == 2 ? grade[1] : 0;
+        switch (grade[0]) {
+            case 'A': g = mod == '+' ? Grade::APlus : mod == '-' ? Grade::AMinus : mod ? Grade::Unknown : Grade::A; break;
+            case 'B': g = mod == '+' ? Grade::BPlus : mod == '-' ? Grade::BMinus : mod ? Grade::Unknown : Grade::B; break;
+            case 'C': g = mod == '+' ? Grade::CPlus : mod ? Grade::Unknown : Grade::C; break;
+            case 'D': g = mod ? Grade::Unknown : Grade::D; break;
+            case 'F': g = mod ? Grade::Unknown : Grade::F; break;
+        }
+    }
+    if (g != Grade::Unknown) return g;
+    return internGrade(grade);
 }
 
-std::string calculateGrade(int marks) {
-    auto scale = loadGradeScale();
+const char* gradeName(Grade g) {
+    static const char* const names[] = {
+        "A+", "A", "A-", "B+", "B", "B-", "C+", "C", "D", "F", ""
+    };
+    std::uint16_t code = static_cast<std::uint16_t>(g);
+    if (code < firstInterned) return names[code];
+    GradeNames& table = gradeNames();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return table.names[code - firstInterned].c_str();
+}
+
+GradeScale::GradeScale(const std::map<std::string, std::pair<int, int>>& scale) {
     for (const auto& [grade, range] : scale) {
-        if (marks >= range.first && marks <= range.second) {
-            return grade;
+        grades.push_back(parseGrade(grade));
+        ranges.push_back(range);
+    }
+    grades.push_back(Grade::F);
+
+    // First matching entry in scale order wins, same as walking the map.
+    for (int marks = 0; marks <= 100; marks++) {
+        std::size_t i = 0;
+        while (i < ranges.size() &&
+               !(marks >= ranges[i].first && marks <= ranges[i].second)) {
+            i++;
         }
+        table[marks] = grades[i];
     }
-    return "F";
-}
\ No newline at end of file
+}
+
+Grade GradeScale::gradeFor(int marks) const {
+    if (marks >= 0 && marks <= 100) return table[marks];
+    for (std::size_t i = 0; i < ranges.size(); i++) {
+        if (marks >= ranges[i].first && marks <= ranges[i].second) return grades[i];
+    }
+    return Grade::F;
+}
+
+namespace {
+    struct ScaleCache {
+        std::unique_ptr<GradeScale> scale;
+        // Scales replaced by a rebuild. Kept so a reference taken from
+        // gradeScale() before the rebuild stays valid; edits are rare.
+        std::vector<std::unique_ptr<GradeScale>> retired;
+        bool exists = false;
+        std::filesystem::file_time_type mtime;
+        std::uintmax_t size = 0;
+    };
+
+    ScaleCache& scaleCache() {
+        static ScaleCache cache;
+        return cache;
+    }
+
+    void fileStamp(bool& exists, std::filesystem::file_time_type& mtime, std::uintmax_t& size) {
+        std::error_code ec;
+        std::filesystem::directory_entry entry("grade_scale.csv", ec);
+        exists = entry.exists(ec);
+        mtime = {};
+        size = 0;
+        if (exists) {
+            mtime = entry.last_write_time(ec);
+            size = entry.file_size(ec);
+        }
+    }
+
+    void rebuild(ScaleCache& cache) {
+        if (cache.scale) cache.retired.push_back(std::move(cache.scale));
+        fileStamp(cache.exists, cache.mtime, cache.size);
+        cache.scale = std::make_unique<GradeScale>(loadGradeScale());
+    }
+}
+
+const GradeScale& gradeScale() {
+    ScaleCache& cache = scaleCache();
+    if (!cache.scale) rebuild(cache);
+    return *cache.scale;
+}
+
+void invalidateGradeScale() {
+    rebuild(scaleCache());
+}
+
+void refreshGradeScale() {
+    ScaleCache& cache = scaleCache();
+    if (!cache.scale) return;  // read on first use anyway
+    bool exists;
+    std::filesystem::file_time_type mtime;
+    std::uintmax_t size;
+    fileStamp(exists, mtime, size);
+    if (exists != cache.exists || mtime != cache.mtime || size != cache.size) rebuild(cache);
+}
+
+Grade calculateGrade(int marks) {
+    return gradeScale().gradeFor(marks);
+}
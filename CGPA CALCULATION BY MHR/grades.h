@@ -4,16 +4,60 @@
 #include <string>
 #include <map>
 #include <utility>
+#include <vector>
+#include <cstdint>
+
+// The ten built-in grades, then Unknown for an empty or unreadable grade.
+// Any other grade text (names from a custom scale) is interned by
+// parseGrade() and gets a code above Unknown, so gradeName() writes it back
+// exactly as it was read.
+enum class Grade : std::uint16_t {
+    APlus, A, AMinus, BPlus, B, BMinus, CPlus, C, D, F, Unknown
+};
+
+constexpr float gradePointTable[] = {
+    4.0f, 3.75f, 3.5f, 3.25f, 3.0f, 2.75f, 2.5f, 2.25f, 2.0f, 0.0f
+};
+
+constexpr bool isBuiltinGrade(Grade g) {
+    return g < Grade::Unknown;
+}
+
+constexpr float gradePoint(Grade g) {
+    return isBuiltinGrade(g) ? gradePointTable[static_cast<std::uint16_t>(g)] : 0.0f;
+}
+
+Grade parseGrade(const std::string& grade);
+const char* gradeName(Grade g);
 
 struct Course {
     std::string name;
     int marks;
     int credit;
-    std::string grade;
+    Grade grade;
+};
+
+// Grade scale compiled into a dense marks -> grade table for 0..100.
+class GradeScale {
+public:
+    explicit GradeScale(const std::map<std::string, std::pair<int, int>>& scale);
+    Grade gradeFor(int marks) const;
+
+private:
+    std::vector<Grade> grades;
+    std::vector<std::pair<int, int>> ranges;
+    Grade table[101];
 };
 
 std::map<std::string, std::pair<int, int>> loadGradeScale();
-std::map<std::string, float> loadGradePoints();
-std::string calculateGrade(int marks);
 
-#endif
\ No newline at end of file
+// Cached scale, read from grade_scale.csv on first use. It is only re-read
+// at explicit points: invalidateGradeScale() after this program rewrote the
+// file (scale editor, restore), refreshGradeScale() at login to pick up an
+// edit made from outside. References stay valid across a re-read.
+const GradeScale& gradeScale();
+void invalidateGradeScale();
+void refreshGradeScale();
+Grade calculateGrade(int marks);
+
+#endif
@@ -3,10 +3,12 @@
 #include "cfaculty.h"
 #include "cadmin.h"
 #include "filemanager.h"
+#include "userdirectory.h"
+#include "gradelog.h"
+#include "grades.h"
 #include "win.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <limits>
 
 User* login() {
@@ -20,24 +22,14 @@ User* login() {
     std::cout << "Password: ";
     std::cin >> password;
 
-    std::ifstream file("users.csv");
-    if (file) {
-        std::string line;
-        while (std::getline(file, line)) {
-            std::stringstream ss(line);
-            std::string storedUser, storedPass, storedRole;
-            std::getline(ss, storedUser, ',');
-            std::getline(ss, storedPass, ',');
-            std::getline(ss, storedRole);
-            if (storedUser == username && storedPass == password && storedRole == role) {
-                if (role == "student")
-                    return new Student(username, password);
-                else if (role == "faculty")
-                    return new Faculty(username, password);
-                else if (role == "admin")
-                    return new Admin(username, password);
-            }
-        }
+    const UserRecord* user = userDirectory().find(username);
+    if (user && user->password == password && user->role == role) {
+        if (role == "student")
+            return new Student(username, password);
+        else if (role == "faculty")
+            return new Faculty(username, password);
+        else if (role == "admin")
+            return new Admin(username, password);
     }
     return nullptr;
 }
@@ -73,6 +65,7 @@ void registerUser() {
 }
 
 void mainMenu() {
+    gradeLog();  // replays grades.wal if the last run stopped before a checkpoint
     User* currentUser = nullptr;
     while (true) {
         clearScreen();
@@ -86,6 +79,7 @@ void mainMenu() {
         if (choice == 1) {
             currentUser = login();
             if (currentUser) {
+                refreshGradeScale();
                 currentUser->showDashboard();
                 delete currentUser;
             } else {
@@ -0,0 +1,76 @@
+#include "threadpool.h"
+
+ThreadPool& threadPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    for (unsigned i = 0; i < threads; i++) workers.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void ThreadPool::work() {
+    unsigned long seen = 0;
+    while (true) {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) return;
+        seen = generation;
+        lock.unlock();
+
+        // Items are claimed one at a time: per-item cost varies a lot
+        // (file sizes differ), so this keeps every core busy to the end.
+        for (std::size_t i; (i = next++) < count;) {
+            try {
+                (*job)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(mutex);
+                if (!failure) failure = std::current_exception();
+            }
+            done++;
+        }
+
+        lock.lock();
+        if (--pending == 0) finished.notify_all();
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t n, const std::function<void(std::size_t)>& body,
+                             const std::function<void(std::size_t)>& progress,
+                             std::chrono::milliseconds progressInterval) {
+    std::unique_lock<std::mutex> lock(mutex);
+    job = &body;
+    count = n;
+    next = 0;
+    done = 0;
+    failure = nullptr;
+    pending = size();
+    generation++;
+    wake.notify_all();
+
+    // Every worker checks in and out of each job, so none of them can still
+    // be reading `job` or `count` once we return.
+    auto complete = [&] { return pending == 0; };
+    while (!finished.wait_for(lock, progressInterval, complete)) {
+        if (progress) {
+            lock.unlock();
+            progress(done);
+            lock.lock();
+        }
+    }
+    if (progress) progress(count);
+    job = nullptr;
+
+    if (failure) std::rethrow_exception(failure);
+}
@@ -0,0 +1,48 @@
+#ifndef THREAD_POOL
+#define THREAD_POOL
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that run one parallelFor job at a time.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = 0);  // 0: one per hardware thread
+    ~ThreadPool();
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+    // Runs body(i) for every i in [0, count) on the workers and blocks until
+    // all are done. While waiting, the calling thread reports the number of
+    // finished items to progress (if given) every progressInterval. The first
+    // exception thrown by body is rethrown here.
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& body,
+                     const std::function<void(std::size_t)>& progress = nullptr,
+                     std::chrono::milliseconds progressInterval = std::chrono::milliseconds(200));
+
+private:
+    void work();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake, finished;
+
+    const std::function<void(std::size_t)>* job = nullptr;
+    std::size_t count = 0;
+    std::atomic<std::size_t> next{0}, done{0};
+    unsigned pending = 0;  // workers that have not finished this job
+    unsigned long generation = 0;
+    bool stopping = false;
+    std::exception_ptr failure;
+};
+
+ThreadPool& threadPool();
+
+#endif
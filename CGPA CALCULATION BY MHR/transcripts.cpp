@@ -0,0 +1,132 @@
+#include "transcripts.h"
+#include "userdirectory.h"
+#include "filemanager.h"
+#include "cgpa.h"
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+namespace {
+    void appendInt(std::string& out, int value) {
+        char buf[16];
+        auto result = std::to_chars(buf, buf + sizeof buf, value);
+        out.append(buf, result.ptr);
+    }
+
+    void appendEscaped(std::string& out, const std::string& text) {
+        for (char c : text) {
+            switch (c) {
+                case '&': out += "&amp;"; break;
+                case '<': out += "&lt;"; break;
+                case '>': out += "&gt;"; break;
+                case '"': out += "&quot;"; break;
+                default: out += c;
+            }
+        }
+    }
+
+    bool writeFile(const std::string& path, const std::string& data) {
+        std::FILE* out = std::fopen(path.c_str(), "wb");
+        if (!out) return false;
+        bool ok = std::fwrite(data.data(), 1, data.size(), out) == data.size();
+        return std::fclose(out) == 0 && ok;
+    }
+
+    // Reserved once per worker thread and only cleared between students, so
+    // rendering does not allocate after the first few transcripts.
+    struct Buffers {
+        std::string csv, html, path;
+        Buffers() {
+            csv.reserve(64 << 10);
+            html.reserve(256 << 10);
+        }
+    };
+}
+
+void renderTranscriptCsv(const std::vector<Course>& courses, std::string& out) {
+    out += "Course,Marks,Credit,Grade\n";
+    for (const auto& course : courses) {
+        out += course.name;
+        out += ',';
+        appendInt(out, course.marks);
+        out += ',';
+        appendInt(out, course.credit);
+        out += ',';
+        out += gradeName(course.grade);
+        out += '\n';
+    }
+}
+
+void renderTranscriptHtml(const std::string& username, const std::vector<Course>& courses, std::string& out) {
+    out += "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>Transcript - ";
+    appendEscaped(out, username);
+    out += "</title>\n<style>body{font-family:sans-serif;margin:2em}table{border-collapse:collapse}"
+           "th,td{border:1px solid #999;padding:4px 12px;text-align:left}@media print{body{margin:0}}</style>\n"
+           "</head><body>\n<h1>Academic Transcript</h1>\n<p>Student: <b>";
+    appendEscaped(out, username);
+    out += "</b></p>\n<table>\n<tr><th>Course</th><th>Marks</th><th>Credits</th><th>Grade</th></tr>\n";
+    for (const auto& course : courses) {
+        out += "<tr><td>";
+        appendEscaped(out, course.name);
+        out += "</td><td>";
+        appendInt(out, course.marks);
+        out += "</td><td>";
+        appendInt(out, course.credit);
+        out += "</td><td>";
+        out += gradeName(course.grade);
+        out += "</td></tr>\n";
+    }
+
+    CgpaTotals totals = totalsOf(courses);
+    char cgpa[32];
+    std::snprintf(cgpa, sizeof cgpa, "%.2f", totals.cgpa());
+    out += "</table>\n<p>Courses: ";
+    appendInt(out, totals.courses);
+    out += " &middot; Credits: ";
+    appendInt(out, totals.credits);
+    out += " &middot; CGPA: <b>";
+    out += cgpa;
+    out += "</b></p>\n</body></html>\n";
+}
+
+TranscriptStats writeTranscripts(const std::string& dir, ThreadPool& pool,
+                                 const std::function<void(std::size_t, std::size_t)>& progress) {
+    auto start = std::chrono::steady_clock::now();
+    TranscriptStats stats;
+
+    std::vector<const UserRecord*> students;
+    for (const auto& user : userDirectory().all()) {
+        if (user.role == "student") students.push_back(&user);
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::size_t> failed{0};
+    std::size_t total = students.size();
+    pool.parallelFor(total, [&](std::size_t i) {
+        thread_local Buffers buf;
+        const std::string& username = students[i]->username;
+        std::vector<Course> courses = loadCourses(username);
+
+        buf.csv.clear();
+        buf.html.clear();
+        renderTranscriptCsv(courses, buf.csv);
+        renderTranscriptHtml(username, courses, buf.html);
+
+        buf.path.assign(dir).append("/").append(username).append("_transcript.csv");
+        bool ok = writeFile(buf.path, buf.csv);
+        buf.path.replace(buf.path.size() - 3, 3, "html");
+        ok = writeFile(buf.path, buf.html) && ok;
+        if (!ok) failed++;
+        bytes += buf.csv.size() + buf.html.size();
+    }, progress ? [&](std::size_t done) { progress(done, total); } : std::function<void(std::size_t)>());
+
+    stats.students = total;
+    stats.failed = failed;
+    stats.bytes = bytes;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
@@ -0,0 +1,32 @@
+#ifndef TRANSCRIPTS
+#define TRANSCRIPTS
+
+#include "grades.h"
+#include "threadpool.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct TranscriptStats {
+    std::size_t students = 0;
+    std::size_t failed = 0;           // students whose files could not be written
+    std::uint64_t bytes = 0;          // CSV and HTML together
+    double seconds = 0;
+
+    double transcriptsPerSecond() const { return seconds > 0 ? students / seconds : 0; }
+};
+
+// Appends a transcript to out: the CSV is what a student exports from their
+// dashboard, the HTML a printable page with the same rows and the CGPA.
+void renderTranscriptCsv(const std::vector<Course>& courses, std::string& out);
+void renderTranscriptHtml(const std::string& username, const std::vector<Course>& courses, std::string& out);
+
+// Writes <dir>/<username>_transcript.csv and .html for every student in
+// users.csv. Students are rendered on the pool into per-thread buffers that
+// are reused from one student to the next, and each file goes out with a
+// single write.
+TranscriptStats writeTranscripts(const std::string& dir, ThreadPool& pool,
+                                 const std::function<void(std::size_t done, std::size_t total)>& progress = nullptr);
+
+#endif
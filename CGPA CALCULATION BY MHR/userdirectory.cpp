@@ -0,0 +1,78 @@
+#include "userdirectory.h"
+#include <fstream>
+#include <sstream>
+
+namespace {
+    std::uint64_t hashName(std::string_view s) {
+        std::uint64_t h = 14695981039346656037ull;
+        for (unsigned char c : s) {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+}
+
+UserDirectory& userDirectory() {
+    static UserDirectory directory;
+    return directory;
+}
+
+void UserDirectory::load() {
+    loaded = true;
+    slots.assign(64, 0);
+    std::ifstream file("users.csv");
+    std::string line;
+    while (std::getline(file, line)) {
+        UserRecord u;
+        std::stringstream ss(line);
+        std::getline(ss, u.username, ',');
+        std::getline(ss, u.password, ',');
+        std::getline(ss, u.role);
+        if (slots[probe(u.username)]) continue;
+        records.push_back(std::move(u));
+        index(static_cast<std::uint32_t>(records.size() - 1));
+    }
+}
+
+std::size_t UserDirectory::probe(std::string_view username) const {
+    std::size_t mask = slots.size() - 1;
+    std::size_t i = hashName(username) & mask;
+    while (slots[i] && records[slots[i] - 1].username != username) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+void UserDirectory::index(std::uint32_t record) {
+    if ((records.size()) * 2 > slots.size()) grow();
+    slots[probe(records[record].username)] = record + 1;
+}
+
+void UserDirectory::grow() {
+    std::vector<std::uint32_t> old;
+    old.swap(slots);
+    slots.assign(old.size() * 2, 0);
+    for (std::uint32_t s : old) {
+        if (s) slots[probe(records[s - 1].username)] = s;
+    }
+}
+
+const UserRecord* UserDirectory::find(std::string_view username) {
+    if (!loaded) load();
+    std::uint32_t s = slots[probe(username)];
+    return s ? &records[s - 1] : nullptr;
+}
+
+void UserDirectory::add(const std::string& username, const std::string& password, const std::string& role) {
+    if (!loaded) load();
+    std::ofstream file("users.csv", std::ios::app);
+    file << username << "," << password << "," << role << "\n";
+    records.push_back({username, password, role});
+    index(static_cast<std::uint32_t>(records.size() - 1));
+}
+
+const std::vector<UserRecord>& UserDirectory::all() {
+    if (!loaded) load();
+    return records;
+}
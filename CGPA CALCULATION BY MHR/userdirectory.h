@@ -0,0 +1,37 @@
+#ifndef USER_DIRECTORY
+#define USER_DIRECTORY
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+struct UserRecord {
+    std::string username;
+    std::string password;
+    std::string role;
+};
+
+// users.csv loaded once into an open-addressing hash index on username.
+class UserDirectory {
+public:
+    const UserRecord* find(std::string_view username);
+    bool exists(std::string_view username) { return find(username) != nullptr; }
+    void add(const std::string& username, const std::string& password, const std::string& role);
+    const std::vector<UserRecord>& all();
+    void reload() { loaded = false; records.clear(); slots.clear(); }  // after users.csv is replaced
+
+private:
+    void load();
+    void index(std::uint32_t record);
+    void grow();
+    std::size_t probe(std::string_view username) const;
+
+    bool loaded = false;
+    std::vector<UserRecord> records;
+    std::vector<std::uint32_t> slots;  // record index + 1, 0 when empty
+};
+
+UserDirectory& userDirectory();
+
+#endif
@@ -8,6 +8,25 @@
 #include <iomanip>
 #include <algorithm> 
 #include <limits>   
+#include <unordered_map>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <string_view>
+#include <charconv>
+#include <thread>
+#include <future>
+#include <iterator>
+#include <deque>
+#ifdef _WIN32
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
 
 using namespace std;
 
@@ -359,42 +378,384 @@ private:
 };
 
 
+// Built-in grades, then Unknown for an empty grade. Any other grade text (a
+// custom scale's names) is interned by parseGrade() with a code above
+// Unknown, so gradeName() writes it back unchanged.
+enum class Grade : uint16_t {
+    APlus, A, AMinus, BPlus, B, BMinus, CPlus, C, D, F, Unknown
+};
+
+constexpr float gradePointTable[] = {
+    4.0f, 3.75f, 3.5f, 3.25f, 3.0f, 2.75f, 2.5f, 2.25f, 2.0f, 0.0f
+};
+
+constexpr bool isBuiltinGrade(Grade g) { return g < Grade::Unknown; }
+
+constexpr float gradePoint(Grade g) { return isBuiltinGrade(g) ? gradePointTable[static_cast<uint16_t>(g)] : 0.0f; }
+
+Grade parseGrade(const string& grade);
+const char* gradeName(Grade g);
+
 map<string, pair<int, int>> loadGradeScale();
-map<string, float> loadGradePoints();
-string calculateGrade(int marks);
+Grade calculateGrade(int marks);
 
-class Message {
+// Grade scale compiled once into a marks -> grade table for 0..100.
+class GradeScale {
 private:
-    string sender;
-    string receiver;
-    string content;
-    time_t timestamp;
+    vector<Grade> grades;
+    vector<pair<int, int>> ranges;
+    Grade table[101];
 public:
-    Message(string s, string r, string c) : sender(s), receiver(r), content(c) {
-        timestamp = time(nullptr);
+    explicit GradeScale(const map<string, pair<int, int>>& scale);
+    Grade gradeFor(int marks) const;
+};
+
+const GradeScale& gradeScale();
+void invalidateGradeScale();
+
+// A message as readers see it. The views point into SystemManager's name
+// table and arena or into the mapped messages.txt, and stay valid as long as
+// the SystemManager does.
+struct MessageView {
+    string_view sender, receiver, content;
+    time_t timestamp = 0;
+
+    string_view getSender() const { return sender; }
+    string_view getReceiver() const { return receiver; }
+    string_view getContent() const { return content; }
+    time_t getTimestamp() const { return timestamp; }
+};
+
+// Splits one "sender|receiver|content|time" line of messages.txt. Lines
+// without a sender, receiver or time are rejected. The time is read like
+// stol: leading blanks, optional sign, trailing text ignored.
+bool splitMessageLine(string_view line, MessageView& out) {
+    size_t a = line.find('|');
+    size_t b = a == string_view::npos ? a : line.find('|', a + 1);
+    size_t c = b == string_view::npos ? b : line.find('|', b + 1);
+    if (c == string_view::npos || a == 0 || b == a + 1) return false;
+
+    string_view timeStr = line.substr(c + 1);
+    while (!timeStr.empty() && isspace(static_cast<unsigned char>(timeStr.front()))) timeStr.remove_prefix(1);
+    if (!timeStr.empty() && timeStr.front() == '+') timeStr.remove_prefix(1);
+    long timestamp;
+    if (from_chars(timeStr.data(), timeStr.data() + timeStr.size(), timestamp).ec != errc()) return false;
+
+    out.sender = line.substr(0, a);
+    out.receiver = line.substr(a + 1, b - a - 1);
+    out.content = line.substr(b + 1, c - b - 1);
+    out.timestamp = static_cast<time_t>(timestamp);
+    return true;
+}
+
+// Bump-pointer arena for immutable strings. Nothing is freed or moved until
+// the arena goes away, so views into it stay valid.
+class Arena {
+    vector<unique_ptr<char[]>> blocks;
+    char* next = nullptr;
+    size_t left = 0;
+    size_t reserved = 0;
+    static constexpr size_t blockSize = 1 << 20;
+
+public:
+    string_view copy(string_view s) {
+        if (s.size() > left) {
+            size_t size = max(s.size(), blockSize);
+            blocks.emplace_back(new char[size]);
+            next = blocks.back().get();
+            left = size;
+            reserved += size;
+        }
+        if (!s.empty()) memcpy(next, s.data(), s.size());
+        string_view out(next, s.size());
+        next += s.size();
+        left -= s.size();
+        return out;
+    }
+
+    // Takes over other's blocks; views into them remain valid.
+    void adopt(Arena& other) {
+        for (auto& block : other.blocks) blocks.push_back(move(block));
+        reserved += other.reserved;
+        other.blocks.clear();
+        other.next = nullptr;
+        other.left = other.reserved = 0;
+    }
+
+    size_t bytesReserved() const { return reserved; }
+};
+
+// Usernames stored once and named by a dense 32-bit id.
+class NameTable {
+    Arena bytes;
+    vector<string_view> names;
+    unordered_map<string_view, uint32_t> ids;
+
+public:
+    static constexpr uint32_t none = UINT32_MAX;
+
+    uint32_t intern(string_view name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        string_view stored = bytes.copy(name);
+        uint32_t id = static_cast<uint32_t>(names.size());
+        names.push_back(stored);
+        ids.emplace(stored, id);
+        return id;
     }
-    Message(string s, string r, string c, time_t t) :
-        sender(s), receiver(r), content(c), timestamp(t) {}
 
-    string getSender() const { return sender; }
-    string getReceiver() const { return receiver; }
-    string getContent() const { return content; }
+    uint32_t find(string_view name) const {
+        auto it = ids.find(name);
+        return it == ids.end() ? none : it->second;
+    }
+
+    string_view view(uint32_t id) const { return names[id]; }
+    size_t size() const { return names.size(); }
+};
+
+// One stored message: name ids for sender and receiver and the body as a
+// view into an arena (or the loaded snapshot). 32 bytes on 64-bit targets.
+class Message {
+    const char* content;
+    time_t timestamp;
+    uint32_t contentSize;
+    uint32_t sender;
+    uint32_t receiver;
+
+public:
+    Message(uint32_t s, uint32_t r, string_view c, time_t t) :
+        content(c.data()), timestamp(t), contentSize(static_cast<uint32_t>(c.size())), sender(s), receiver(r) {}
+
+    uint32_t getSender() const { return sender; }
+    uint32_t getReceiver() const { return receiver; }
+    string_view getContent() const { return string_view(content, contentSize); }
     time_t getTimestamp() const { return timestamp; }
 };
 
+// Read-only memory mapping of a whole file. An empty or missing file maps
+// to an empty view.
+class MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const string& filename) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                           nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER len;
+        if (!GetFileSizeEx(file, &len) || len.QuadPart == 0) return false;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return false;
+        data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (data) size = static_cast<size_t>(len.QuadPart);
+#else
+        FILE* f = fopen(filename.c_str(), "rb");
+        if (!f) return false;
+        struct stat st;
+        if (fstat(fileno(f), &st) == 0 && st.st_size > 0) {
+            void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+            if (p != MAP_FAILED) {
+                data = static_cast<const char*>(p);
+                size = static_cast<size_t>(st.st_size);
+            }
+        }
+        fclose(f);
+#endif
+        return data != nullptr;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+        mapping = nullptr;
+#else
+        if (data) munmap(const_cast<char*>(data), size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    // Hands the pages read so far back to the OS; they are faulted in again
+    // from the page cache if touched later.
+    void release() {
+#ifndef _WIN32
+        if (data) madvise(const_cast<char*>(data), size, MADV_DONTNEED);
+#endif
+    }
+
+    string_view view() const { return string_view(data, size); }
+};
+
+// messages.txt served straight from a mapping. Startup records only where
+// each valid line starts and how long it is; fields are split out of the
+// mapping when a message is read.
+class MappedMessages {
+    MappedFile file;
+    vector<uint64_t> offsets;
+    vector<uint32_t> lengths;
+
+public:
+    // Indexes every valid line, calling onMessage(index, view) for each.
+    template <typename F>
+    void open(const string& path, F onMessage) {
+        offsets.clear();
+        lengths.clear();
+        if (!file.open(path)) return;
+
+        string_view text = file.view();
+        MessageView view;
+        for (size_t pos = 0; pos < text.size();) {
+            size_t nl = text.find('\n', pos);
+            size_t end = nl == string_view::npos ? text.size() : nl;
+            if (end - pos <= UINT32_MAX && splitMessageLine(text.substr(pos, end - pos), view)) {
+                onMessage(offsets.size(), view);
+                offsets.push_back(pos);
+                lengths.push_back(static_cast<uint32_t>(end - pos));
+            }
+            pos = end + 1;
+        }
+        file.release();
+    }
+
+    size_t size() const { return offsets.size(); }
+
+    MessageView at(size_t i) const {
+        MessageView view;
+        splitMessageLine(file.view().substr(offsets[i], lengths[i]), view);
+        return view;
+    }
+};
+
 struct Course {
     string name;
     int marks;
     int credit;
-    string grade;
+    Grade grade;
+};
+
+// Running totals behind a CGPA, in whole quarter points: every grade point
+// is a multiple of 0.25, so courses can be added and removed without drift.
+// Grades outside the built-in ones count as courses but carry no credit, as
+// in calculateCGPA.
+struct CgpaTotals {
+    int64_t quarterPoints = 0;
+    int credits = 0;
+    int courses = 0;
+
+    void add(const Course& c, int sign = 1) {
+        courses += sign;
+        if (!isBuiltinGrade(c.grade)) return;
+        quarterPoints += sign * static_cast<int64_t>(gradePoint(c.grade) * 4) * c.credit;
+        credits += sign * c.credit;
+    }
+    void remove(const Course& c) { add(c, -1); }
+    float cgpa() const { return credits > 0 ? static_cast<float>(quarterPoints / (4.0 * credits)) : 0.0f; }
+};
+
+float calculateCGPA(const vector<Course>& courses);
+
+enum class Role : uint8_t { Student, Faculty, Admin };
+
+bool parseRole(string_view name, Role& role) {
+    if (name == "student") role = Role::Student;
+    else if (name == "faculty") role = Role::Faculty;
+    else if (name == "admin") role = Role::Admin;
+    else return false;
+    return true;
+}
+
+const char* roleName(Role role) {
+    switch (role) {
+        case Role::Student: return "student";
+        case Role::Faculty: return "faculty";
+        default: return "admin";
+    }
+}
+
+// One account. The strings live in the owning UserPool's arena.
+struct UserRecord {
+    string_view username;
+    string_view password;
+    Role role;
+
+    string_view getUsername() const { return username; }
+    Role getRole() const { return role; }
 };
 
+// All accounts in one dense array, addressed by a 32-bit handle that stays
+// valid for the life of the pool (accounts are never removed). Lookup by
+// username goes through an open-addressing table of handles, so loading an
+// account costs one record, one slot and its bytes in the arena.
+class UserPool {
+    Arena text;
+    vector<UserRecord> records;
+    vector<uint32_t> slots; // handle or none; size is a power of two
+
+    size_t slotFor(string_view username) const {
+        size_t mask = slots.size() - 1;
+        size_t i = hash<string_view>()(username) & mask;
+        while (slots[i] != none && records[slots[i]].username != username) i = (i + 1) & mask;
+        return i;
+    }
+
+    void rehash(size_t capacity) {
+        slots.assign(capacity, none);
+        for (uint32_t id = 0; id < records.size(); id++) slots[slotFor(records[id].username)] = id;
+    }
+
+public:
+    static constexpr uint32_t none = UINT32_MAX;
+
+    // Keeps the table at most half full for n accounts.
+    void reserve(size_t n) {
+        records.reserve(n);
+        size_t capacity = 16;
+        while (capacity < n * 2) capacity *= 2;
+        if (capacity > slots.size()) rehash(capacity);
+    }
+
+    // Returns the new handle, or none if the username is taken.
+    uint32_t add(string_view username, string_view password, Role role) {
+        if ((records.size() + 1) * 2 > slots.size()) reserve(max<size_t>(records.size() * 2, 8));
+        size_t slot = slotFor(username);
+        if (slots[slot] != none) return none;
+        uint32_t id = static_cast<uint32_t>(records.size());
+        records.push_back({text.copy(username), text.copy(password), role});
+        slots[slot] = id;
+        return id;
+    }
+
+    uint32_t find(string_view username) const {
+        if (slots.empty()) return none;
+        return slots[slotFor(username)];
+    }
+
+    const UserRecord& operator[](uint32_t id) const { return records[id]; }
+    size_t size() const { return records.size(); }
+    vector<UserRecord>::const_iterator begin() const { return records.begin(); }
+    vector<UserRecord>::const_iterator end() const { return records.end(); }
+};
+
+// Dashboards for the logged-in account. One is built on the stack for each
+// session from the account's role; accounts themselves are plain records.
 class User {
 protected:
     string username;
-    string password;
-    string role;
-    static int userCount;
 
     void printHeader(const string& title) {
         system("cls");
@@ -404,64 +765,350 @@ protected:
     }
 
 public:
-    User(string uname, string pwd, string r) : username(uname), password(pwd), role(r) {
-        userCount++;
-    }
-    virtual ~User() { userCount--; }
-    virtual void displayDashboard(SystemManager& sys) = 0;
-
-    string getUsername() const { return username; }
-    string getRole() const { return role; }
-    static int getUserCount() { return userCount; }
-
-
-    virtual float calculateCGPA() { return 0.0f; }
-    virtual void viewReport() {}
-    virtual void enterGrades(SystemManager& sys) {}
-    virtual void configureGradeScale(SystemManager& sys) {}
-    virtual void editGrades(SystemManager& sys) {}
-
-    friend class SystemManager; 
+    explicit User(string_view uname) : username(uname) {}
+    const string& getUsername() const { return username; }
 };
-int User::userCount = 0;
 
 class Student : public User {
     vector<Course> courses;
+    float cgpa = 0;
     void loadCourses(SystemManager& sys);
 
 public:
-    Student(string uname, string pwd) : User(uname, pwd, "student") {}
-    void displayDashboard(SystemManager& sys) override;
-    float calculateCGPA() override;
-    void viewReport() override;
+    using User::User;
+    void displayDashboard(SystemManager& sys);
+    float calculateCGPA();
+    void viewReport();
 };
 
 class Faculty : public User {
 public:
-    Faculty(string uname, string pwd) : User(uname, pwd, "faculty") {}
-    void displayDashboard(SystemManager& sys) override;
-    void enterGrades(SystemManager& sys) override;
+    using User::User;
+    void displayDashboard(SystemManager& sys);
+    void enterGrades(SystemManager& sys);
 };
 
 class Admin : public User {
 public:
-    Admin(string uname, string pwd) : User(uname, pwd, "admin") {}
-    void displayDashboard(SystemManager& sys) override;
-    void configureGradeScale(SystemManager& sys) override;
-    void editGrades(SystemManager& sys) override;
+    using User::User;
+    void displayDashboard(SystemManager& sys);
+    void configureGradeScale(SystemManager& sys);
+    void editGrades(SystemManager& sys);
+};
+
+// Binary snapshot of users and messages (snapshot.bin) for fast startup:
+//   SnapshotHeader | SnapshotString[names] | SnapshotUser[users]
+//   | SnapshotMessage[messages] | text
+// All records are fixed width; usernames, passwords and roles are interned
+// in the names table and every string's bytes live in the text block. The
+// whole file is loaded with one read.
+//
+// The header records how many bytes of users.csv and messages.txt were
+// covered and a hash of the last few KB before that point. Files that only
+// grew since are handled by parsing just the new tail; anything else means
+// they were rewritten and the snapshot is ignored.
+struct SnapshotSource {
+    uint64_t size;
+    uint64_t tailHash;
+
+    static uint64_t hashTail(const string& path, uint64_t size) {
+        char buf[4096];
+        uint64_t n = min<uint64_t>(size, sizeof buf);
+        uint64_t h = 14695981039346656037ull;
+        ifstream in(path, ios::binary);
+        if (in.seekg(static_cast<streamoff>(size - n)) && in.read(buf, static_cast<streamsize>(n))) {
+            for (uint64_t i = 0; i < n; i++) {
+                h ^= static_cast<unsigned char>(buf[i]);
+                h *= 1099511628211ull;
+            }
+        }
+        return h;
+    }
+
+    static uint64_t sizeOf(const string& path) {
+        error_code ec;
+        uint64_t size = filesystem::file_size(path, ec);
+        return ec ? 0 : size;
+    }
+
+    static SnapshotSource of(const string& path) {
+        uint64_t size = sizeOf(path);
+        return {size, hashTail(path, size)};
+    }
+
+    // True when the file still starts with the bytes the snapshot covered.
+    bool covers(const string& path) const {
+        return sizeOf(path) >= size && hashTail(path, size) == tailHash;
+    }
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t nameCount, userCount, messageCount, textBytes;
+    SnapshotSource users, messages;
+};
+
+struct SnapshotString { uint64_t offset; uint32_t size, reserved; };
+struct SnapshotUser { uint32_t username, password, role, reserved; };
+struct SnapshotMessage { int64_t time; uint32_t sender, receiver; uint64_t content; uint32_t contentSize, reserved; };
+
+const char snapshotMagic[8] = {'M', 'C', 'C', 'S', 'N', 'A', 'P', '\0'};
+const uint32_t snapshotVersion = 1;
+
+// Collects records and writes them in one pass. Strings are kept as views,
+// so whatever they point into must outlive write().
+class SnapshotWriter {
+    vector<string_view> names;
+    unordered_map<string_view, uint32_t> nameIds;
+    vector<SnapshotUser> users;
+    vector<SnapshotMessage> messages;
+    vector<string_view> contents;
+    uint64_t nameBytes = 0, contentBytes = 0;
+
+    uint32_t intern(string_view s) {
+        auto [it, added] = nameIds.emplace(s, static_cast<uint32_t>(names.size()));
+        if (added) {
+            names.push_back(s);
+            nameBytes += s.size();
+        }
+        return it->second;
+    }
+
+public:
+    void addUser(string_view username, string_view password, string_view role) {
+        users.push_back({intern(username), intern(password), intern(role), 0});
+    }
+
+    void addMessage(int64_t time, string_view sender, string_view receiver, string_view content) {
+        messages.push_back({time, intern(sender), intern(receiver), contentBytes, static_cast<uint32_t>(content.size()), 0});
+        contents.push_back(content);
+        contentBytes += content.size();
+    }
+
+    // Writes path.tmp and renames it over path once it is complete.
+    bool write(const string& path, SnapshotSource usersSource, SnapshotSource messagesSource) {
+        SnapshotHeader header{};
+        memcpy(header.magic, snapshotMagic, sizeof header.magic);
+        header.version = snapshotVersion;
+        header.nameCount = names.size();
+        header.userCount = users.size();
+        header.messageCount = messages.size();
+        header.textBytes = nameBytes + contentBytes;
+        header.users = usersSource;
+        header.messages = messagesSource;
+
+        // Names come first in the text block, message bodies after them.
+        vector<SnapshotString> refs;
+        refs.reserve(names.size());
+        uint64_t offset = 0;
+        for (string_view name : names) {
+            refs.push_back({offset, static_cast<uint32_t>(name.size()), 0});
+            offset += name.size();
+        }
+        for (auto& m : messages) m.content += nameBytes;
+
+        string tmp = path + ".tmp";
+        {
+            ofstream out(tmp, ios::binary | ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof header);
+            out.write(reinterpret_cast<const char*>(refs.data()), refs.size() * sizeof(SnapshotString));
+            out.write(reinterpret_cast<const char*>(users.data()), users.size() * sizeof(SnapshotUser));
+            out.write(reinterpret_cast<const char*>(messages.data()), messages.size() * sizeof(SnapshotMessage));
+            for (string_view name : names) out.write(name.data(), name.size());
+            for (string_view c : contents) out.write(c.data(), c.size());
+            out.close();
+            for (auto& m : messages) m.content -= nameBytes;
+            if (!out) {
+                error_code ec;
+                filesystem::remove(tmp, ec);
+                return false;
+            }
+        }
+        error_code ec;
+        filesystem::rename(tmp, path, ec);
+        return !ec;
+    }
+};
+
+// A snapshot read into memory with one read. open() validates the header
+// and every reference up front, so the accessors do no checking.
+class SnapshotFile {
+    unique_ptr<uint64_t[]> data; // 8-byte aligned storage for the records
+    const SnapshotHeader* head = nullptr;
+    const SnapshotString* nameRefs = nullptr;
+    const SnapshotUser* userRecords = nullptr;
+    const SnapshotMessage* messageRecords = nullptr;
+    const char* text = nullptr;
+
+public:
+    bool open(const string& path) {
+        uint64_t size = SnapshotSource::sizeOf(path);
+        if (size < sizeof(SnapshotHeader)) return false;
+        data.reset(new uint64_t[(size + 7) / 8]);
+        ifstream in(path, ios::binary);
+        if (!in.read(reinterpret_cast<char*>(data.get()), static_cast<streamsize>(size))) return false;
+
+        const char* base = reinterpret_cast<const char*>(data.get());
+        head = reinterpret_cast<const SnapshotHeader*>(base);
+        if (memcmp(head->magic, snapshotMagic, sizeof head->magic) != 0 || head->version != snapshotVersion) return false;
+
+        // Counts are checked against the bytes left before multiplying, so a
+        // corrupt header cannot overflow the offsets.
+        uint64_t at = sizeof(SnapshotHeader);
+        auto take = [&](uint64_t count, uint64_t width) {
+            if (count > (size - at) / width) return false;
+            at += count * width;
+            return true;
+        };
+        uint64_t names = at;
+        if (!take(head->nameCount, sizeof(SnapshotString))) return false;
+        uint64_t users = at;
+        if (!take(head->userCount, sizeof(SnapshotUser))) return false;
+        uint64_t messages = at;
+        if (!take(head->messageCount, sizeof(SnapshotMessage)) || size - at != head->textBytes) return false;
+        nameRefs = reinterpret_cast<const SnapshotString*>(base + names);
+        userRecords = reinterpret_cast<const SnapshotUser*>(base + users);
+        messageRecords = reinterpret_cast<const SnapshotMessage*>(base + messages);
+        text = base + at;
+
+        const uint64_t n = head->nameCount, t = head->textBytes;
+        for (uint64_t i = 0; i < n; i++) {
+            if (nameRefs[i].offset > t || nameRefs[i].size > t - nameRefs[i].offset) return false;
+        }
+        for (uint64_t i = 0; i < head->userCount; i++) {
+            const SnapshotUser& u = userRecords[i];
+            if (u.username >= n || u.password >= n || u.role >= n) return false;
+        }
+        for (uint64_t i = 0; i < head->messageCount; i++) {
+            const SnapshotMessage& m = messageRecords[i];
+            if (m.sender >= n || m.receiver >= n || m.content > t || m.contentSize > t - m.content) return false;
+        }
+        return true;
+    }
+
+    const SnapshotHeader& header() const { return *head; }
+    string_view name(uint32_t id) const { return string_view(text + nameRefs[id].offset, nameRefs[id].size); }
+    const SnapshotUser& user(size_t i) const { return userRecords[i]; }
+    const SnapshotMessage& message(size_t i) const { return messageRecords[i]; }
+    string_view content(const SnapshotMessage& m) const { return string_view(text + m.content, m.contentSize); }
 };
 
 class SystemManager {
 private:
-    vector<User*> users;
+    UserPool users;
+    // Message i is mapped[i] for the first mapped.size() messages (mapped
+    // mode only) and messages[i - mapped.size()] after that.
+    MappedMessages mapped;
+    bool mappedMode = false;
     vector<Message> messages;
-    User* currentUser = nullptr;
+    NameTable names;          // senders and receivers
+    Arena bodies;             // message contents
+    SnapshotFile snapshot;    // kept open: messages loaded from it point into it
+    vector<vector<size_t>> inbox; // receiver name id -> message indices
+    uint32_t currentUser = UserPool::none;
+    ofstream usersOut, messagesOut;
+
+    // Per-student CGPA totals, journalled in cgpa_totals.log as
+    // "username,quarterPoints,credits,courses,size,mtime" (last line wins).
+    // Each entry is stamped with the size and write time of the course file
+    // it was taken from; a file changed outside addGrade/editGrade no longer
+    // matches and is re-read on the next cgpaTotals().
+    struct CgpaEntry {
+        CgpaTotals totals;
+        int64_t size = -1, mtime = 0; // size -1: no course file
+    };
+    unordered_map<string, CgpaEntry> cgpaEntries;
+    bool cgpaLoaded = false;
+    ofstream cgpaOut;
+
+    static void stampCourseFile(const string& username, CgpaEntry& e) {
+        error_code ec;
+        string file = username + ".csv";
+        auto size = filesystem::file_size(file, ec);
+        auto mtime = ec ? filesystem::file_time_type() : filesystem::last_write_time(file, ec);
+        e.size = ec ? -1 : static_cast<int64_t>(size);
+        e.mtime = ec ? 0 : static_cast<int64_t>(mtime.time_since_epoch().count());
+    }
 
-public:
-    ~SystemManager() {
-        for (auto user : users) delete user;
+    void writeCgpaLine(const string& username, const CgpaEntry& e) {
+        cgpaOut << username << ',' << e.totals.quarterPoints << ',' << e.totals.credits << ','
+                << e.totals.courses << ',' << e.size << ',' << e.mtime << '\n';
+    }
+
+    void recordCgpa(const string& username, const CgpaEntry& e) {
+        cgpaEntries[username] = e;
+        writeCgpaLine(username, e);
     }
 
+    // Replays the journal, compacting it once stale lines outnumber live ones.
+    void loadCgpaJournal() {
+        cgpaLoaded = true;
+        size_t lines = 0;
+        ifstream in("cgpa_totals.log");
+        string line;
+        while (getline(in, line)) {
+            lines++;
+            size_t comma = line.find(',');
+            if (comma == 0 || comma == string::npos) continue;
+            CgpaEntry e;
+            const char* p = line.data() + comma + 1;
+            const char* end = line.data() + line.size();
+            bool ok = true;
+            auto field = [&](auto& value) {
+                auto r = from_chars(p, end, value);
+                ok = ok && r.ec == errc() && (r.ptr == end || *r.ptr == ',');
+                p = r.ptr == end ? end : r.ptr + 1;
+            };
+            field(e.totals.quarterPoints);
+            field(e.totals.credits);
+            field(e.totals.courses);
+            field(e.size);
+            field(e.mtime);
+            if (ok && p == end) cgpaEntries[line.substr(0, comma)] = e;
+        }
+        in.close();
+
+        if (lines > 2 * cgpaEntries.size() + 1024) {
+            cgpaOut.open("cgpa_totals.log.tmp", ios::trunc);
+            for (const auto& [username, e] : cgpaEntries) writeCgpaLine(username, e);
+            cgpaOut.close();
+            error_code ec;
+            if (cgpaOut) filesystem::rename("cgpa_totals.log.tmp", "cgpa_totals.log", ec);
+        }
+        cgpaOut.clear();
+        cgpaOut.open("cgpa_totals.log", ios::app);
+    }
+
+    // Records a student's totals just after their course file was changed.
+    void commitCgpa(const string& username, const CgpaTotals& totals) {
+        if (!cgpaLoaded) loadCgpaJournal();
+        CgpaEntry e{totals};
+        stampCourseFile(username, e);
+        recordCgpa(username, e);
+        cgpaOut.flush();
+    }
+
+    void indexMessage(uint32_t receiver, size_t i) {
+        if (receiver >= inbox.size()) inbox.resize(names.size());
+        inbox[receiver].push_back(i);
+    }
+
+    // Stores a message whose content already lives in bodies or snapshot.
+    void storeMessage(uint32_t sender, uint32_t receiver, string_view content, time_t time) {
+        messages.emplace_back(sender, receiver, content, time);
+        indexMessage(receiver, messageCount() - 1);
+    }
+
+    // Adds a users.csv or snapshot account; unknown roles and taken
+    // usernames are skipped.
+    void loadUser(string_view username, string_view password, string_view roleStr) {
+        Role role;
+        if (parseRole(roleStr, role)) users.add(username, password, role);
+    }
+
+public:
     void pauseScreen() {
         cout << "\nPress Enter to continue...";
         cin.clear();
@@ -469,26 +1116,97 @@ public:
         cin.get();
     }
 
-    bool userExists(const string& username) {
-        for (auto user : users) {
-            if (user->getUsername() == username) return true;
-        }
-        return false;
+    bool userExists(string_view username) const {
+        return users.find(username) != UserPool::none;
     }
 
+    // The record stays valid until the next account is added.
+    const UserRecord* getUserByUsername(string_view username) const {
+        uint32_t id = users.find(username);
+        return id == UserPool::none ? nullptr : &users[id];
+    }
 
-    User* getUserByUsername(const string& username) {
-        for (auto user : users) {
-            if (user->getUsername() == username) {
-                return user;
-            }
+    // Prompt-free operations shared by the menus and batch mode. Each one
+    // returns false and fills `error` when the request is rejected.
+
+    bool addUser(const string& username, const string& password, const string& role, string& error) {
+        if (userExists(username)) { error = "Username exists!"; return false; }
+        Role parsed;
+        if (!parseRole(role, parsed)) { error = "Invalid role!"; return false; }
+        if (parsed == Role::Student) ofstream(username + ".csv").close();
+
+        users.add(username, password, parsed);
+        if (!usersOut.is_open()) usersOut.open("users.csv", ios::app);
+        usersOut << username << "," << password << "," << role << "\n";
+        usersOut.flush();
+        return true;
+    }
+
+    bool authenticate(const string& username, const string& password) {
+        uint32_t id = users.find(username);
+        if (id == UserPool::none || users[id].password != password) return false;
+        currentUser = id;
+        return true;
+    }
+
+    bool postMessage(const string& receiver, const string& content, string& error) {
+        if (!isLoggedIn()) { error = "Not logged in!"; return false; }
+        if (!userExists(receiver)) { error = "Receiver not found!"; return false; }
+        storeMessage(names.intern(users[currentUser].username), names.intern(receiver), bodies.copy(content), time(nullptr));
+
+        MessageView msg = messageAt(messageCount() - 1);
+        if (!messagesOut.is_open()) messagesOut.open("messages.txt", ios::app);
+        messagesOut << msg.getSender() << "|" << msg.getReceiver() << "|"
+                    << msg.getContent() << "|" << msg.getTimestamp() << "\n";
+        messagesOut.flush();
+        return true;
+    }
+
+    bool isStudent(string_view username) const {
+        const UserRecord* user = getUserByUsername(username);
+        return user && user->role == Role::Student;
+    }
+
+    bool addGrade(const string& student, Course& c, string& error) {
+        if (!isStudent(student)) { error = "Student not found or user is not a student!"; return false; }
+        if (c.name.empty()) { error = "Course name required!"; return false; }
+        if (c.marks < 0 || c.marks > 100) { error = "Marks must be between 0 and 100!"; return false; }
+        if (c.credit <= 0 || c.credit > 6) { error = "Credit hours must be 1-6!"; return false; }
+        c.grade = calculateGrade(c.marks);
+
+        CgpaTotals totals = cgpaTotals(student);
+        ofstream out(student + ".csv", ios::app);
+        if (!out) { error = "Could not open " + student + ".csv!"; return false; }
+        out << c.name << "," << c.marks << "," << c.credit << "," << gradeName(c.grade) << "\n";
+        out.close();
+        totals.add(c);
+        commitCgpa(student, totals);
+        return true;
+    }
+
+    // courseNumber is 1-based, as shown in the edit menu.
+    bool editGrade(const string& student, int courseNumber, int marks, string& error) {
+        if (!isStudent(student)) { error = "Student not found or user is not a student!"; return false; }
+        if (marks < 0 || marks > 100) { error = "Marks must be between 0 and 100!"; return false; }
+        vector<Course> courses_vec = loadStudentCourses(student);
+        if (courseNumber < 1 || courseNumber > static_cast<int>(courses_vec.size())) {
+            error = "Invalid course number!";
+            return false;
         }
-        return nullptr;
+        CgpaTotals totals = cgpaTotals(student);
+        Course& c = courses_vec[courseNumber - 1];
+        totals.remove(c);
+        c.marks = marks;
+        c.grade = calculateGrade(marks);
+        totals.add(c);
+        saveStudentCourses(student, courses_vec);
+        commitCgpa(student, totals);
+        return true;
     }
 
 
     void registerUser() {
-        string username, password, role;
+        string username, password, role, error;
         cout << "Enter username: ";
         cin >> username;
         if (userExists(username)) {
@@ -501,22 +1219,11 @@ public:
         cout << "Enter role (student/faculty/admin): ";
         cin >> role;
 
-        User* newUser = nullptr;
-        if (role == "student") {
-            newUser = new Student(username, password);
-            ofstream gradeFile(username + ".csv");
-            gradeFile.close();
-        }
-        else if (role == "faculty") newUser = new Faculty(username, password);
-        else if (role == "admin") newUser = new Admin(username, password);
-        else {
-            cout << "Invalid role!\n";
+        if (!addUser(username, password, role, error)) {
+            cout << error << "\n";
             pauseScreen();
             return;
         }
-
-        users.push_back(newUser);
-        saveUsersToFile();
         cout << "Registration successful!\n";
         pauseScreen();
     }
@@ -528,13 +1235,10 @@ public:
         cout << "Password: ";
         cin >> password;
 
-        for (auto user : users) {
-            if (user->getUsername() == username && user->password == password) { 
-                currentUser = user;
-                cout << "Login successful!\n";
-                pauseScreen();
-                return true;
-            }
+        if (authenticate(username, password)) {
+            cout << "Login successful!\n";
+            pauseScreen();
+            return true;
         }
         cout << "Invalid credentials!\n";
         pauseScreen();
@@ -542,111 +1246,268 @@ public:
     }
 
     void logout() {
-        currentUser = nullptr;
+        endSession();
         system("cls");
     }
 
+    void endSession() { currentUser = UserPool::none; }
+
     void sendMessage(string receiver, string content) {
-        if (!currentUser) return;
-        if (!userExists(receiver)) {
-            cout << "Receiver not found!\n";
+        if (!isLoggedIn()) return;
+        string error;
+        if (!postMessage(receiver, content, error)) {
+            cout << error << "\n";
             pauseScreen();
             return;
         }
-        messages.emplace_back(currentUser->getUsername(), receiver, content);
-        saveMessagesToFile();
         cout << "Message sent!\n";
         pauseScreen();
     }
 
     void viewInbox() {
-        if (!currentUser) return;
-        string username = currentUser->getUsername();
-        bool found = false;
+        if (!isLoggedIn()) return;
+        const vector<size_t>& received = inboxFor(users[currentUser].username);
 
         cout << "\n--- Your Messages ---\n";
-        for (auto& msg : messages) {
-            if (msg.getReceiver() == username) {
-                time_t timestamp = msg.getTimestamp();
-                cout << "From: " << msg.getSender() << "\nContent: "
-                     << msg.getContent() << "\nTime: " << ctime(&timestamp)
-                     << "-------------------------\n";
-                found = true;
-            }
+        for (size_t i : received) {
+            MessageView msg = messageAt(i);
+            time_t timestamp = msg.getTimestamp();
+            cout << "From: " << msg.getSender() << "\nContent: "
+                 << msg.getContent() << "\nTime: " << ctime(&timestamp)
+                 << "-------------------------\n";
         }
 
-        if (!found) cout << "No messages found!\n";
+        if (received.empty()) cout << "No messages found!\n";
         pauseScreen();
     }
 
-    void saveUsersToFile() {
-        ofstream file("users.csv");
+    // Reads users.csv from byte offset `from` in one piece and splits it in
+    // place, so an account costs no allocation of its own.
+    void loadUsersFromFile(streamoff from = 0) {
+        ifstream file("users.csv", ios::binary);
         if (!file) { return; }
-        for (auto user : users) {
-            file << user->getUsername() << "," << user->password << "," << user->getRole() << "\n"; 
+        file.seekg(0, ios::end);
+        streamoff size = file.tellg();
+        if (size <= from) return;
+        string text(static_cast<size_t>(size - from), '\0');
+        file.seekg(from);
+        file.read(&text[0], text.size());
+        text.resize(static_cast<size_t>(file.gcount()));
+        users.reserve(users.size() + count(text.begin(), text.end(), '\n') + 1);
+
+        string_view rest(text);
+        while (!rest.empty()) {
+            size_t eol = rest.find('\n');
+            string_view line = rest.substr(0, eol);
+            rest.remove_prefix(eol == string_view::npos ? rest.size() : eol + 1);
+
+            string_view field[3];
+            for (string_view& f : field) {
+                size_t comma = line.find(',');
+                f = line.substr(0, comma);
+                line.remove_prefix(comma == string_view::npos ? line.size() : comma + 1);
+            }
+            if (field[0].empty() || field[1].empty() || field[2].empty()) continue;
+            loadUser(field[0], field[1], field[2]);
         }
     }
 
-    void loadUsersFromFile() {
-        ifstream file("users.csv");
-        if (!file) { return; }
-        string line;
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string username, password, role;
-            getline(ss, username, ',');
-            getline(ss, password, ',');
-            getline(ss, role, ',');
-
-            if (username.empty() || password.empty() || role.empty()) continue;
+    // messages.txt is split into newline-aligned byte ranges that are parsed
+    // on separate threads. Each range has its own name table and arena, so
+    // workers share nothing; ranges are appended in file order, which gives
+    // the same result as a single sequential pass.
+    struct MessageChunk {
+        NameTable names;
+        Arena bodies;
+        vector<Message> messages; // ids are local to this chunk's names
+    };
 
-            User* user = nullptr;
-            if (role == "student") user = new Student(username, password);
-            else if (role == "faculty") user = new Faculty(username, password);
-            else if (role == "admin") user = new Admin(username, password);
+    static bool parseMessageLine(string_view line, MessageChunk& out) {
+        MessageView view;
+        if (!splitMessageLine(line, view)) return false;
+        out.messages.emplace_back(out.names.intern(view.sender), out.names.intern(view.receiver),
+                                  out.bodies.copy(view.content), view.timestamp);
+        return true;
+    }
 
-            if (user && !userExists(username)) {
-                 users.push_back(user);
-            } else if (user) {
-                delete user;
+    static void parseMessageRange(const string& path, uintmax_t begin, uintmax_t end, MessageChunk& out) {
+        ifstream file(path, ios::binary);
+        file.seekg(static_cast<streamoff>(begin));
+        const size_t block = 1 << 20;
+        string buf;
+        size_t carry = 0;
+        for (uintmax_t pos = begin; pos < end || carry;) {
+            size_t want = static_cast<size_t>(min<uintmax_t>(block, end - pos));
+            buf.resize(carry + want);
+            file.read(&buf[carry], static_cast<streamsize>(want));
+            size_t got = static_cast<size_t>(file.gcount());
+            pos += got;
+            size_t size = carry + got;
+            bool last = got == 0 || pos >= end;
+
+            size_t start = 0;
+            for (size_t nl; (nl = buf.find('\n', start)) < size; start = nl + 1) {
+                parseMessageLine(string_view(buf.data() + start, nl - start), out);
             }
+            if (last) {
+                if (start < size) parseMessageLine(string_view(buf.data() + start, size - start), out);
+                break;
+            }
+            carry = size - start;
+            buf.erase(0, start);
         }
     }
 
-    void saveMessagesToFile() {
-        ofstream file("messages.txt");
-        if (!file) { return; }
-        for (auto& msg : messages) {
-            file << msg.getSender() << "|" << msg.getReceiver() << "|"
-                 << msg.getContent() << "|" << msg.getTimestamp() << "\n";
+    void loadMessagesFromFile() {
+        const string path = "messages.txt";
+        error_code ec;
+        uintmax_t size = filesystem::file_size(path, ec);
+        if (ec || size == 0) { return; }
+
+        // At least 4 MiB per range so small files stay on one thread.
+        unsigned threads = max(1u, thread::hardware_concurrency());
+        size_t ranges = static_cast<size_t>(max<uintmax_t>(1, min<uintmax_t>(threads, size >> 22)));
+
+        // Move each nominal boundary forward to just past the next newline.
+        vector<uintmax_t> bounds{0};
+        ifstream probe(path, ios::binary);
+        for (size_t i = 1; i < ranges; i++) {
+            uintmax_t at = max(bounds.back(), size * i / ranges);
+            probe.clear();
+            probe.seekg(static_cast<streamoff>(at - 1));
+            char ch;
+            while (probe.get(ch) && ch != '\n') {}
+            bounds.push_back(probe ? static_cast<uintmax_t>(probe.tellg()) : size);
         }
+        bounds.push_back(size);
+
+        vector<MessageChunk> chunks(ranges);
+        vector<thread> workers;
+        for (size_t i = 1; i < ranges; i++) {
+            workers.emplace_back(parseMessageRange, cref(path), bounds[i], bounds[i + 1], ref(chunks[i]));
+        }
+        parseMessageRange(path, bounds[0], bounds[1], chunks[0]);
+        for (auto& w : workers) w.join();
+
+        size_t total = messages.size();
+        for (const auto& chunk : chunks) total += chunk.messages.size();
+        messages.reserve(total);
+        for (auto& chunk : chunks) appendChunk(chunk);
     }
 
-    void loadMessagesFromFile() {
-        ifstream file("messages.txt");
-        if (!file) { return; }
-        string line;
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string sender, receiver, content, timeStr;
-            getline(ss, sender, '|');
-            getline(ss, receiver, '|');
-            getline(ss, content, '|');
-            getline(ss, timeStr);
+    void appendChunk(MessageChunk& chunk) {
+        vector<uint32_t> ids(chunk.names.size());
+        for (uint32_t id = 0; id < ids.size(); id++) ids[id] = names.intern(chunk.names.view(id));
+        bodies.adopt(chunk.bodies);
+        for (const Message& m : chunk.messages) {
+            storeMessage(ids[m.getSender()], ids[m.getReceiver()], m.getContent(), m.getTimestamp());
+        }
+        vector<Message>().swap(chunk.messages);
+    }
 
-            if (sender.empty() || receiver.empty() || timeStr.empty()) continue;
+    bool loadSnapshot() {
+        SnapshotFile file;
+        if (!file.open("snapshot.bin")) return false;
+        const SnapshotHeader& header = file.header();
+        if (!header.users.covers("users.csv") || !header.messages.covers("messages.txt")) return false;
+        snapshot = move(file);
+
+        users.reserve(header.userCount);
+        for (size_t i = 0; i < header.userCount; i++) {
+            const SnapshotUser& u = snapshot.user(i);
+            loadUser(snapshot.name(u.username), snapshot.name(u.password), snapshot.name(u.role));
+        }
 
-            try {
-                time_t timestamp = stol(timeStr);
-                messages.emplace_back(sender, receiver, content, timestamp);
-            } catch (const std::invalid_argument&) {
-            } catch (const std::out_of_range&) {
-            }
+        // Snapshot name ids map onto ours on first use; bodies stay where
+        // they are in the snapshot's text block.
+        vector<uint32_t> ids(header.nameCount, NameTable::none);
+        auto idFor = [&](uint32_t id) {
+            if (ids[id] == NameTable::none) ids[id] = names.intern(snapshot.name(id));
+            return ids[id];
+        };
+        messages.reserve(header.messageCount);
+        for (size_t i = 0; i < header.messageCount; i++) {
+            const SnapshotMessage& m = snapshot.message(i);
+            storeMessage(idFor(m.sender), idFor(m.receiver), snapshot.content(m), static_cast<time_t>(m.time));
+        }
+
+        // Whatever was appended after the snapshot was taken.
+        loadUsersFromFile(static_cast<streamoff>(header.users.size));
+        uint64_t size = SnapshotSource::sizeOf("messages.txt");
+        if (size > header.messages.size) {
+            MessageChunk tail;
+            parseMessageRange("messages.txt", header.messages.size, size, tail);
+            appendChunk(tail);
         }
+        return true;
     }
 
-    bool isLoggedIn() { return currentUser != nullptr; }
-    User* getCurrentUser() { return currentUser; }
+    // Mapped mode: messages.txt stays on disk and only an offset index and
+    // the inboxes are built. Resident memory then grows with the messages
+    // actually opened, not with the size of the history.
+    void useMappedMessages() { mappedMode = true; }
+
+    void loadMappedMessages() {
+        mapped.open("messages.txt", [&](size_t i, const MessageView& msg) {
+            indexMessage(names.intern(msg.receiver), i);
+        });
+    }
+
+    // Users and messages live in separate members, so both text files can
+    // be read at once when there is no usable snapshot.
+    void loadFromFiles() {
+        if (mappedMode) {
+            auto usersLoaded = async(launch::async, [this] { loadUsersFromFile(); });
+            loadMappedMessages();
+            usersLoaded.get();
+            return;
+        }
+        if (loadSnapshot()) return;
+        auto usersLoaded = async(launch::async, [this] { loadUsersFromFile(); });
+        loadMessagesFromFile();
+        usersLoaded.get();
+    }
+
+    // Captures the current users and messages; called on exit and from the
+    // admin menu. users.csv and messages.txt are flushed after every append,
+    // so their sizes match what is in memory.
+    bool saveSnapshot() {
+        SnapshotWriter writer;
+        for (const UserRecord& user : users) writer.addUser(user.username, user.password, roleName(user.role));
+        for (size_t i = 0; i < messageCount(); i++) {
+            MessageView msg = messageAt(i);
+            writer.addMessage(msg.getTimestamp(), msg.getSender(), msg.getReceiver(), msg.getContent());
+        }
+        return writer.write("snapshot.bin", SnapshotSource::of("users.csv"), SnapshotSource::of("messages.txt"));
+    }
+
+    bool isLoggedIn() const { return currentUser != UserPool::none; }
+    // The record stays valid until the next account is added.
+    const UserRecord* getCurrentUser() const { return isLoggedIn() ? &users[currentUser] : nullptr; }
+
+    // Runs the logged-in account's dashboard until it logs out.
+    void showDashboard() {
+        string_view username = users[currentUser].username;
+        switch (users[currentUser].role) {
+            case Role::Student: Student(username).displayDashboard(*this); break;
+            case Role::Faculty: Faculty(username).displayDashboard(*this); break;
+            case Role::Admin: Admin(username).displayDashboard(*this); break;
+        }
+    }
+
+    const vector<size_t>& inboxFor(string_view username) const {
+        static const vector<size_t> empty;
+        uint32_t id = names.find(username);
+        return id < inbox.size() ? inbox[id] : empty;
+    }
+
+    size_t messageCount() const { return mapped.size() + messages.size(); }
+
+    MessageView messageAt(size_t i) const {
+        if (i < mapped.size()) return mapped.at(i);
+        const Message& m = messages[i - mapped.size()];
+        return {names.view(m.getSender()), names.view(m.getReceiver()), m.getContent(), m.getTimestamp()};
+    }
 
     vector<Course> loadStudentCourses(const string& username) {
         vector<Course> courses_vec;
@@ -659,9 +1520,11 @@ public:
                 getline(ss, c.name, ',');
                 ss >> c.marks; ss.ignore();
                 ss >> c.credit; ss.ignore();
-                getline(ss, c.grade);
+                string grade;
+                getline(ss, grade);
 
-                if (c.name.empty() || c.grade.empty() || c.credit <=0) continue;
+                if (c.name.empty() || grade.empty() || c.credit <=0) continue;
+                c.grade = parseGrade(grade);
 
                 courses_vec.push_back(c);
             }
@@ -669,18 +1532,34 @@ public:
         return courses_vec;
     }
 
+    // A student's CGPA totals: the journalled entry while it still matches
+    // the course file, otherwise rebuilt from the file and journalled.
+    CgpaTotals cgpaTotals(const string& username) {
+        if (!cgpaLoaded) loadCgpaJournal();
+        CgpaEntry e;
+        stampCourseFile(username, e);
+        auto it = cgpaEntries.find(username);
+        if (it != cgpaEntries.end() && it->second.size == e.size && it->second.mtime == e.mtime) {
+            return it->second.totals;
+        }
+        for (const auto& c : loadStudentCourses(username)) e.totals.add(c);
+        recordCgpa(username, e);
+        return e.totals;
+    }
+
     void saveStudentCourses(const string& username, const vector<Course>& courses_vec) {
         ofstream out(username + ".csv");
         if (!out) { return; }
         for (const auto& c : courses_vec) {
             out << c.name << "," << c.marks << ","
-                << c.credit << "," << c.grade << "\n";
+                << c.credit << "," << gradeName(c.grade) << "\n";
         }
     }
 };
 
 void Student::loadCourses(SystemManager& sys) {
     courses = sys.loadStudentCourses(username);
+    cgpa = sys.cgpaTotals(username).cgpa();
 }
 
 void Student::displayDashboard(SystemManager& sys) {
@@ -720,18 +1599,13 @@ void Student::displayDashboard(SystemManager& sys) {
 }
 
 float Student::calculateCGPA() {
-    if (courses.empty()) return 0.0f;
-    float totalPoints = 0;
-    int totalCredits = 0;
-    map<string, float> gradeValues = loadGradePoints();
-
-    for (const auto& course : courses) {
-        if (gradeValues.count(course.grade)) {
-            totalPoints += gradeValues[course.grade] * course.credit;
-            totalCredits += course.credit;
-        }
-    }
-    return totalCredits > 0 ? totalPoints / totalCredits : 0.0f;
+    return cgpa;
+}
+
+float calculateCGPA(const vector<Course>& courses) {
+    CgpaTotals totals;
+    for (const auto& course : courses) totals.add(course);
+    return totals.cgpa();
 }
 
 void Student::viewReport() {
@@ -745,7 +1619,7 @@ void Student::viewReport() {
 
         for (const auto& course : courses) {
             cout << setw(25) << course.name << setw(10) << course.marks
-                 << setw(10) << course.credit << course.grade << endl;
+                 << setw(10) << course.credit << gradeName(course.grade) << endl;
         }
         cout << "\nCGPA: " << fixed << setprecision(2) << calculateCGPA() << endl;
     }
@@ -795,9 +1669,7 @@ void Faculty::enterGrades(SystemManager& sys) {
     cout << "Enter student's username: ";
     cin >> studentName;
 
-    User* tempUser = sys.getUserByUsername(studentName); 
-
-    if (!tempUser || tempUser->getRole() != "student") {
+    if (!sys.isStudent(studentName)) {
         cout << "Student not found or user is not a student!\n";
         sys.pauseScreen();
         return;
@@ -821,13 +1693,14 @@ void Faculty::enterGrades(SystemManager& sys) {
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
     }
 
-    c.grade = calculateGrade(c.marks);
-
-    vector<Course> studentCourses = sys.loadStudentCourses(studentName);
-    studentCourses.push_back(c);
-    sys.saveStudentCourses(studentName, studentCourses);
+    string error;
+    if (!sys.addGrade(studentName, c, error)) {
+        cout << "\n" << error << "\n";
+        sys.pauseScreen();
+        return;
+    }
 
-    cout << "\nGrade for " << c.name << " (" << c.grade << ") added successfully for " << studentName << "!\n";
+    cout << "\nGrade for " << c.name << " (" << gradeName(c.grade) << ") added successfully for " << studentName << "!\n";
     sys.pauseScreen();
 }
 
@@ -837,7 +1710,7 @@ void Admin::displayDashboard(SystemManager& sys) {
         printHeader("ADMIN DASHBOARD");
         cout << "Welcome, Admin " << username << "!\n\n";
         cout << "1. View Inbox\n2. Send Message\n3. Configure Grade Scale\n"
-             << "4. Edit Student Grades\n5. Logout\nChoice: ";
+             << "4. Edit Student Grades\n5. Save Snapshot\n6. Logout\nChoice: ";
         cin >> choice;
 
         switch (choice) {
@@ -856,7 +1729,11 @@ void Admin::displayDashboard(SystemManager& sys) {
             }
             case 3: configureGradeScale(sys); break;
             case 4: editGrades(sys); break;
-            case 5: sys.logout(); break;
+            case 5:
+                cout << (sys.saveSnapshot() ? "Snapshot saved.\n" : "Snapshot could not be saved!\n");
+                sys.pauseScreen();
+                break;
+            case 6: sys.logout(); break;
             default:
                 cout << "Invalid choice. Please try again.\n";
                 sys.pauseScreen();
@@ -885,6 +1762,8 @@ void Admin::configureGradeScale(SystemManager& sys) {
             file << line << "\n";
             cout << "Entry '" << line << "' added.\n";
         }
+        file.close();
+        invalidateGradeScale();
         cout << "\nGrade scale configuration updated!\n";
     }
     else {
@@ -900,8 +1779,7 @@ void Admin::editGrades(SystemManager& sys) {
     cin >> studentName;
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
-    User* tempUser = sys.getUserByUsername(studentName); 
-    if (!tempUser || tempUser->getRole() != "student") {
+    if (!sys.isStudent(studentName)) {
         cout << "Student not found or user is not a student!\n";
         sys.pauseScreen();
         return;
@@ -917,7 +1795,7 @@ void Admin::editGrades(SystemManager& sys) {
     cout << "\nCourses for " << studentName << ":\n";
     for (size_t i = 0; i < courses.size(); ++i) {
         cout << i + 1 << ". " << courses[i].name << " (Marks: " << courses[i].marks
-             << ", Credits: " << courses[i].credit << ", Grade: " << courses[i].grade << ")\n";
+             << ", Credits: " << courses[i].credit << ", Grade: " << gradeName(courses[i].grade) << ")\n";
     }
 
     int courseChoice;
@@ -944,22 +1822,78 @@ void Admin::editGrades(SystemManager& sys) {
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
     }
 
+    string error;
+    if (!sys.editGrade(studentName, courseChoice, C_to_edit.marks, error)) {
+        cout << "\n" << error << "\n";
+        sys.pauseScreen();
+        return;
+    }
     C_to_edit.grade = calculateGrade(C_to_edit.marks);
 
-    sys.saveStudentCourses(studentName, courses);
-    cout << "\nGrade for " << C_to_edit.name << " updated to " << C_to_edit.grade
+    cout << "\nGrade for " << C_to_edit.name << " updated to " << gradeName(C_to_edit.grade)
          << " (Marks: " << C_to_edit.marks << ").\n";
     sys.pauseScreen();
 }
 
-string calculateGrade(int marks) {
-    map<string, pair<int, int>> scale = loadGradeScale();
+GradeScale::GradeScale(const map<string, pair<int, int>>& scale) {
     for (const auto& entry : scale) {
-        if (marks >= entry.second.first && marks <= entry.second.second) {
-            return entry.first;
-        }
+        grades.push_back(parseGrade(entry.first));
+        ranges.push_back(entry.second);
+    }
+    grades.push_back(Grade::F);
+
+    for (int marks = 0; marks <= 100; marks++) {
+        size_t i = 0;
+        while (i < ranges.size() && !(marks >= ranges[i].first && marks <= ranges[i].second)) i++;
+        table[marks] = grades[i];
     }
-    return "F";
+}
+
+Grade GradeScale::gradeFor(int marks) const {
+    if (marks >= 0 && marks <= 100) return table[marks];
+    for (size_t i = 0; i < ranges.size(); i++) {
+        if (marks >= ranges[i].first && marks <= ranges[i].second) return grades[i];
+    }
+    return Grade::F;
+}
+
+static unsigned gradeScaleVersion = 0;
+
+// Rebuilt only when grade_scale.csv changes on disk or the admin edits it.
+const GradeScale& gradeScale() {
+    static unique_ptr<GradeScale> cached;
+    static bool cachedExists = false;
+    static filesystem::file_time_type cachedTime;
+    static uintmax_t cachedSize = 0;
+    static unsigned cachedVersion = 0;
+
+    error_code ec;
+    filesystem::directory_entry entry("grade_scale.csv", ec);
+    bool exists = entry.exists(ec);
+    filesystem::file_time_type mtime{};
+    uintmax_t size = 0;
+    if (exists) {
+        mtime = entry.last_write_time(ec);
+        size = entry.file_size(ec);
+    }
+
+    if (!cached || exists != cachedExists || mtime != cachedTime ||
+        size != cachedSize || cachedVersion != gradeScaleVersion) {
+        cached = make_unique<GradeScale>(loadGradeScale());
+        cachedExists = exists;
+        cachedTime = mtime;
+        cachedSize = size;
+        cachedVersion = gradeScaleVersion;
+    }
+    return *cached;
+}
+
+void invalidateGradeScale() {
+    gradeScaleVersion++;
+}
+
+Grade calculateGrade(int marks) {
+    return gradeScale().gradeFor(marks);
 }
 
 map<string, pair<int, int>> loadGradeScale() {
@@ -992,18 +1926,162 @@ map<string, pair<int, int>> loadGradeScale() {
     return scale;
 }
 
-map<string, float> loadGradePoints() {
-    return {
-        {"A+", 4.0f}, {"A", 3.75f}, {"A-", 3.5f},
-        {"B+", 3.25f}, {"B", 3.0f}, {"B-", 2.75f},
-        {"C+", 2.5f}, {"C", 2.25f}, {"D", 2.0f}, {"F", 0.0f}
+// Grade text that is not a built-in name, in order of first appearance.
+// A deque keeps the strings in place, so gradeName() can return c_str().
+deque<string> internedGrades;
+unordered_map<string, uint16_t> internedGradeCodes;
+constexpr uint16_t firstInternedGrade = static_cast<uint16_t>(Grade::Unknown) + 1;
+
+Grade parseGrade(const string& text) {
+    // A file saved with CRLF line ends leaves the '\r' on the last field.
+    string_view grade(text);
+    if (!grade.empty() && grade.back() == '\r') grade.remove_suffix(1);
+    if (grade.empty()) return Grade::Unknown;
+
+    Grade g = Grade::Unknown;
+    if (grade.size() <= 2) {
+        char mod = grade.size() == 2 ? grade[1] : 0;
+        switch (grade[0]) {
+            case 'A': g = mod == '+' ? Grade::APlus : mod == '-' ? Grade::AMinus : mod ? Grade::Unknown : Grade::A; break;
+            case 'B': g = mod == '+' ? Grade::BPlus : mod == '-' ? Grade::BMinus : mod ? Grade::Unknown : Grade::B; break;
+            case 'C': g = mod == '+' ? Grade::CPlus : mod ? Grade::Unknown : Grade::C; break;
+            case 'D': g = mod ? Grade::Unknown : Grade::D; break;
+            case 'F': g = mod ? Grade::Unknown : Grade::F; break;
+        }
+    }
+    if (g != Grade::Unknown) return g;
+
+    auto it = internedGradeCodes.find(string(grade));
+    if (it != internedGradeCodes.end()) return static_cast<Grade>(it->second);
+    if (internedGrades.size() >= 0xFFFFu - firstInternedGrade) return Grade::Unknown;
+    uint16_t code = static_cast<uint16_t>(firstInternedGrade + internedGrades.size());
+    internedGrades.emplace_back(grade);
+    internedGradeCodes.emplace(internedGrades.back(), code);
+    return static_cast<Grade>(code);
+}
+
+const char* gradeName(Grade g) {
+    static const char* const names[] = {
+        "A+", "A", "A-", "B+", "B", "B-", "C+", "C", "D", "F", ""
     };
+    uint16_t code = static_cast<uint16_t>(g);
+    return code < firstInternedGrade ? names[code] : internedGrades[code - firstInternedGrade].c_str();
+}
+
+// Batch mode: one command per line, no prompts. Each command produces a
+// tab-separated "line, command, ok|error, microseconds, detail" row and a
+// summary line starting with '#' closes the run.
+//
+//   register <user> <password> <role>
+//   login <user> <password>
+//   logout
+//   send <receiver> <message text>
+//   enter-grade <student> <marks> <credit> <course name>
+//   edit-grade <student> <course number> <marks>
+//   report <student>
+//   snapshot
+//
+// Blank lines and lines starting with '#' are ignored.
+int runBatch(SystemManager& sys, istream& in, ostream& out) {
+    string line;
+    size_t lineNo = 0, succeeded = 0, failed = 0;
+    auto runStart = chrono::steady_clock::now();
+
+    while (getline(in, line)) {
+        lineNo++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        auto start = chrono::steady_clock::now();
+        istringstream args(line);
+        string command, error, detail;
+        args >> command;
+        const UserRecord* user = sys.getCurrentUser();
+        bool ok = false;
+
+        if (command == "register") {
+            string username, password, role;
+            if (args >> username >> password >> role) ok = sys.addUser(username, password, role, error);
+            else error = "usage: register <user> <password> <role>";
+        } else if (command == "login") {
+            string username, password;
+            if (!(args >> username >> password)) error = "usage: login <user> <password>";
+            else if (!(ok = sys.authenticate(username, password))) error = "Invalid credentials!";
+        } else if (command == "logout") {
+            sys.endSession();
+            ok = true;
+        } else if (command == "send") {
+            string receiver, content;
+            if (args >> receiver && getline(args >> ws, content)) ok = sys.postMessage(receiver, content, error);
+            else error = "usage: send <receiver> <message>";
+        } else if (command == "enter-grade") {
+            string student;
+            Course c;
+            if (!user || user->role != Role::Faculty) error = "Faculty login required!";
+            else if (args >> student >> c.marks >> c.credit && getline(args >> ws, c.name)) {
+                ok = sys.addGrade(student, c, error);
+                if (ok) detail = gradeName(c.grade);
+            } else error = "usage: enter-grade <student> <marks> <credit> <course>";
+        } else if (command == "edit-grade") {
+            string student;
+            int courseNumber, marks;
+            if (!user || user->role != Role::Admin) error = "Admin login required!";
+            else if (args >> student >> courseNumber >> marks) ok = sys.editGrade(student, courseNumber, marks, error);
+            else error = "usage: edit-grade <student> <course number> <marks>";
+        } else if (command == "report") {
+            string student;
+            if (!user) error = "Not logged in!";
+            else if (!(args >> student)) error = "usage: report <student>";
+            else if (user->role == Role::Student && user->username != student) error = "Students can only view their own report!";
+            else if (!sys.isStudent(student)) error = "Student not found or user is not a student!";
+            else {
+                CgpaTotals totals = sys.cgpaTotals(student);
+                ostringstream cgpa;
+                cgpa << fixed << setprecision(2) << totals.cgpa();
+                detail = "courses=" + to_string(totals.courses) + " cgpa=" + cgpa.str();
+                ok = true;
+            }
+        } else if (command == "snapshot") {
+            if (!(ok = sys.saveSnapshot())) error = "Could not write snapshot.bin!";
+        } else {
+            error = "unknown command";
+        }
+
+        auto micros = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+        out << lineNo << '\t' << command << '\t' << (ok ? "ok" : "error") << '\t'
+            << micros << '\t' << (ok ? detail : error) << '\n';
+        (ok ? succeeded : failed)++;
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - runStart).count();
+    out << "# commands=" << succeeded + failed << " ok=" << succeeded << " errors=" << failed
+        << " seconds=" << fixed << setprecision(3) << seconds
+        << " ops_per_sec=" << setprecision(0) << (seconds > 0 ? (succeeded + failed) / seconds : 0) << "\n";
+    return failed ? 1 : 0;
 }
 
-int main() {
+// Usage: mcc [--mapped-messages] [--batch [file|-]]
+int main(int argc, char* argv[]) {
+    vector<string> args(argv + 1, argv + argc);
     SystemManager sys;
-    sys.loadUsersFromFile();
-    sys.loadMessagesFromFile();
+    auto mappedFlag = find(args.begin(), args.end(), "--mapped-messages");
+    if (mappedFlag != args.end()) {
+        sys.useMappedMessages();
+        args.erase(mappedFlag);
+    }
+    sys.loadFromFiles();
+
+    if (!args.empty() && args[0] == "--batch") {
+        if (args.size() > 1 && args[1] != "-") {
+            ifstream in(args[1]);
+            if (!in) {
+                cerr << "Cannot open " << args[1] << "\n";
+                return 2;
+            }
+            return runBatch(sys, in, cout);
+        }
+        return runBatch(sys, cin, cout);
+    }
 
     IUBATChatbot bot;
 
@@ -1039,13 +2117,14 @@ int main() {
                     break;
                 case 4:
                     cout << "\nExiting University Management System. Goodbye!\n";
+                    sys.saveSnapshot();
                     return 0;
                 default:
                     cout << "Invalid choice! Please try again.\n";
                     sys.pauseScreen();
             }
         } else {
-            sys.getCurrentUser()->displayDashboard(sys);
+            sys.showDashboard();
         }
     }
     return 0;
@@ -0,0 +1,92 @@
+#ifndef INTERN
+#define INTERN
+
+#include<cstdint>
+#include<cstring>
+#include<memory>
+#include<string_view>
+#include<unordered_map>
+#include<vector>
+
+// Bump-pointer arena for immutable strings. Bytes are never freed or moved
+// until the arena goes away, so views into it stay valid.
+class Arena
+{
+    private:
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* next=nullptr;
+    std::size_t left=0;
+    std::size_t reserved=0;
+    static constexpr std::size_t blockSize=1<<20;
+
+    public:
+    std::string_view copy(std::string_view s)
+    {
+        if(s.size()>left)
+        {
+            std::size_t size=s.size()>blockSize ? s.size() : blockSize;
+            blocks.emplace_back(new char[size]);
+            next=blocks.back().get();
+            left=size;
+            reserved+=size;
+        }
+        if(!s.empty())
+        {
+            std::memcpy(next,s.data(),s.size());
+        }
+        std::string_view out(next,s.size());
+        next+=s.size();
+        left-=s.size();
+        return out;
+    }
+
+    std::size_t bytesReserved() const
+    {
+        return reserved;
+    }
+};
+
+// Usernames (and anything else that repeats a lot) stored once and named by
+// a dense 32-bit id.
+class NameTable
+{
+    private:
+    Arena bytes;
+    std::vector<std::string_view> names;
+    std::unordered_map<std::string_view, std::uint32_t> ids;
+
+    public:
+    static constexpr std::uint32_t none=UINT32_MAX;
+
+    std::uint32_t intern(std::string_view name)
+    {
+        auto it=ids.find(name);
+        if(it!=ids.end())
+        {
+            return it->second;
+        }
+        std::string_view stored=bytes.copy(name);
+        std::uint32_t id=static_cast<std::uint32_t>(names.size());
+        names.push_back(stored);
+        ids.emplace(stored,id);
+        return id;
+    }
+
+    std::uint32_t find(std::string_view name) const
+    {
+        auto it=ids.find(name);
+        return it==ids.end() ? none : it->second;
+    }
+
+    std::string_view view(std::uint32_t id) const
+    {
+        return names[id];
+    }
+
+    std::size_t size() const
+    {
+        return names.size();
+    }
+};
+
+#endif
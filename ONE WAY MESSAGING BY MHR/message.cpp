@@ -3,8 +3,7 @@
 int main ()
 {
     SystemManager sys;
-    sys.loadUsersFromFile();
-    sys.loadMessagesFromFile();
+    sys.load();
 
     while(true)
     {
@@ -30,6 +29,7 @@ int main ()
             }
             case 3:
             {
+                sys.saveSnapshot();
                 return 0;
             }
         }
@@ -2,38 +2,67 @@
 #define MESSAGE
 
 #include<iostream>
-#include<string>
+#include<string_view>
+#include<cstdint>
 #include<ctime>
 
+// One stored message: 32-bit name ids for sender and receiver, the body as
+// a view into SystemManager's arena (or its loaded snapshot).
 class Message
 {
     private:
-    std::string sender;
-    std::string receiver;
-    std::string content;
+    const char* content;
     std::time_t timestamp;
+    std::uint32_t contentSize;
+    std::uint32_t sender;
+    std::uint32_t receiver;
 
     public:
-    Message(std::string s, std::string r, std::string c)
-    : sender(s), receiver(r), content(c)
+    Message(std::uint32_t s, std::uint32_t r, std::string_view c, std::time_t t)
+    : content(c.data()), timestamp(t), contentSize(static_cast<std::uint32_t>(c.size())), sender(s), receiver(r){}
+
+    std::uint32_t getSender() const
     {
-        timestamp=time(nullptr);
+        return sender;
     }
 
-    Message(std::string s, std::string r, std::string c, std::time_t t)
-    : sender(s), receiver(r), content(c), timestamp(t){}
+    std::uint32_t getReceiver() const
+    {
+        return receiver;
+    }
 
-    std::string getSender() const
+    std::string_view getContent() const
+    {
+        return std::string_view(content,contentSize);
+    }
+
+    std::time_t getTimestamp() const
+    {
+        return timestamp;
+    }
+
+};
+
+// A message with its names resolved. The views are only valid as long as
+// whatever produced them (SystemManager, or a log record being replayed).
+struct MessageView
+{
+    std::string_view sender;
+    std::string_view receiver;
+    std::string_view content;
+    std::time_t timestamp;
+
+    std::string_view getSender() const
     {
         return sender;
     }
 
-    std::string getReceiver() const
+    std::string_view getReceiver() const
     {
         return receiver;
     }
 
-    std::string getContent() const
+    std::string_view getContent() const
     {
         return content;
     }
@@ -42,7 +71,17 @@ class Message
     {
         return timestamp;
     }
+};
 
+// One line of an inbox page: the sender, the time and the first few
+// characters of the body. The views live as long as the MessageView would.
+struct MessageHeader
+{
+    std::size_t id;            // pass to SystemManager::openMessage
+    std::string_view sender;
+    std::time_t timestamp;
+    std::string_view preview;
+    bool truncated;            // preview is shorter than the body
 };
 
 #endif
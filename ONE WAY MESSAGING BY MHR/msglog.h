@@ -0,0 +1,246 @@
+#ifndef MESSAGE_LOG
+#define MESSAGE_LOG
+
+#include "msg.h"
+#include "seek.h"
+#include<cstdio>
+#include<cstdint>
+#include<cstring>
+#include<string>
+#include<string_view>
+#include<vector>
+#include<filesystem>
+
+#ifdef _WIN32
+#include<io.h>
+#else
+#include<unistd.h>
+#endif
+
+// Append-only message log. Every message is one framed record:
+//   u32 payload length | u32 checksum | i64 time | u32 sender, receiver,
+//   content lengths | sender | receiver | content
+// A torn record at the tail (crash mid-write) is cut off on replay.
+
+class MessageLog
+{
+    private:
+    std::string path;
+    std::FILE* file=nullptr;
+    std::uintmax_t goodSize=0; // bytes of whole records in the file while it is open for append
+
+    static std::uint32_t checksum(const char* data, std::size_t size)
+    {
+        std::uint32_t h=2166136261u;
+        for(std::size_t i=0;i<size;i++)
+        {
+            h^=static_cast<unsigned char>(data[i]);
+            h*=16777619u;
+        }
+        return h;
+    }
+
+    static void put32(std::string &out, std::uint32_t v)
+    {
+        out.append(reinterpret_cast<const char*>(&v), sizeof v);
+    }
+
+    static std::string frame(const MessageView &msg)
+    {
+        std::string_view s=msg.getSender();
+        std::string_view r=msg.getReceiver();
+        std::string_view c=msg.getContent();
+        std::int64_t t=msg.getTimestamp();
+
+        std::string out;
+        std::uint32_t payload=sizeof t+12+s.size()+r.size()+c.size();
+        out.reserve(8+payload);
+        put32(out,payload);
+        put32(out,0);
+        out.append(reinterpret_cast<const char*>(&t), sizeof t);
+        put32(out,s.size());
+        put32(out,r.size());
+        put32(out,c.size());
+        out+=s;
+        out+=r;
+        out+=c;
+
+        std::uint32_t sum=checksum(out.data()+8, payload);
+        std::memcpy(&out[4], &sum, sizeof sum);
+        return out;
+    }
+
+    static bool sync(std::FILE* f)
+    {
+        if(std::fflush(f)!=0)
+        {
+            return false;
+        }
+#ifdef _WIN32
+        return _commit(_fileno(f))==0;
+#else
+        return fsync(fileno(f))==0;
+#endif
+    }
+
+    public:
+    explicit MessageLog(std::string p)
+    : path(p){}
+
+    ~MessageLog()
+    {
+        close();
+    }
+
+    bool exists() const
+    {
+        return std::filesystem::exists(path);
+    }
+
+    void close()
+    {
+        if(file)
+        {
+            std::fclose(file);
+            file=nullptr;
+        }
+    }
+
+    bool append(const MessageView &msg)
+    {
+        if(!file)
+        {
+            file=std::fopen(path.c_str(),"ab");
+            if(!file)
+            {
+                return false;
+            }
+            std::error_code ec;
+            goodSize=std::filesystem::file_size(path,ec);
+            if(ec)
+            {
+                close();
+                return false;
+            }
+        }
+        std::string record=frame(msg);
+        if(std::fwrite(record.data(),1,record.size(),file)!=record.size() || !sync(file))
+        {
+            // Cut off the partial record, or replay would stop at it and
+            // drop every message appended after it.
+            close();
+            std::error_code ec;
+            std::filesystem::resize_file(path,goodSize,ec);
+            return false;
+        }
+        goodSize+=record.size();
+        return true;
+    }
+
+    const std::string& filePath() const
+    {
+        return path;
+    }
+
+    // Calls onMessage(MessageView) for every intact record from byte offset
+    // `from` on (a record boundary), truncating a damaged tail. The views
+    // only live until onMessage returns.
+    template<typename F>
+    std::size_t replay(F onMessage, std::uintmax_t from=0)
+    {
+        close();
+        std::FILE* in=std::fopen(path.c_str(),"rb");
+        if(!in)
+        {
+            return 0;
+        }
+        if(from && !seekFile(in,from,SEEK_SET))
+        {
+            std::fclose(in);
+            return 0;
+        }
+
+        std::error_code ec;
+        std::uintmax_t fileSize=std::filesystem::file_size(path,ec);
+        if(ec || from>fileSize) // never cut or extend the file from a bad offset
+        {
+            std::fclose(in);
+            return 0;
+        }
+
+        std::size_t count=0;
+        std::uintmax_t good=from;
+        std::vector<char> payload;
+        std::uint32_t header[2];
+
+        while(std::fread(header,sizeof header,1,in)==1)
+        {
+            // The length comes from disk: check it against what is left of
+            // the file before allocating for it.
+            std::uint32_t size=header[0];
+            if(size<20 || size>fileSize-good-sizeof header)
+            {
+                break;
+            }
+            payload.resize(size);
+            if(std::fread(payload.data(),1,size,in)!=size || checksum(payload.data(),size)!=header[1])
+            {
+                break;
+            }
+
+            std::int64_t t;
+            std::uint32_t len[3];
+            std::memcpy(&t, payload.data(), sizeof t);
+            std::memcpy(len, payload.data()+sizeof t, sizeof len);
+            if(std::uint64_t(20)+len[0]+len[1]+len[2]!=size)
+            {
+                break;
+            }
+
+            const char* p=payload.data()+20;
+            onMessage(MessageView{std::string_view(p,len[0]), std::string_view(p+len[0],len[1]),
+                std::string_view(p+len[0]+len[1],len[2]), static_cast<std::time_t>(t)});
+
+            good+=sizeof header+size;
+            count++;
+        }
+        std::fclose(in);
+
+        if(fileSize!=good)
+        {
+            std::filesystem::resize_file(path,good,ec);
+        }
+        return count;
+    }
+
+    // Writes a fresh log holding exactly messageAt(0..count-1) and swaps it in.
+    template<typename F>
+    bool rewrite(std::size_t count, F messageAt)
+    {
+        close();
+        std::string tmp=path+".tmp";
+        std::FILE* out=std::fopen(tmp.c_str(),"wb");
+        if(!out)
+        {
+            return false;
+        }
+        bool ok=true;
+        for(std::size_t i=0;i<count;i++)
+        {
+            std::string record=frame(messageAt(i));
+            ok=ok && std::fwrite(record.data(),1,record.size(),out)==record.size();
+        }
+        ok=sync(out) && ok;
+        std::fclose(out);
+
+        std::error_code ec;
+        if(ok)
+        {
+            std::filesystem::rename(tmp,path,ec);
+        }
+        return ok && !ec;
+    }
+
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef SEEK
+#define SEEK
+
+#include<cstdio>
+#include<cstdint>
+#include<limits>
+
+#ifndef _WIN32
+#include<sys/types.h>
+#endif
+
+// fseek with a 64-bit offset. std::fseek takes a long, which is 32 bits on
+// Windows, so offsets past 2 GiB would wrap.
+inline bool seekFile(std::FILE* file, std::uint64_t offset, int origin)
+{
+#ifdef _WIN32
+    if(offset>static_cast<std::uint64_t>(std::numeric_limits<__int64>::max()))
+    {
+        return false;
+    }
+    return _fseeki64(file,static_cast<__int64>(offset),origin)==0;
+#else
+    if(offset>static_cast<std::uint64_t>(std::numeric_limits<off_t>::max()))
+    {
+        return false;
+    }
+    return fseeko(file,static_cast<off_t>(offset),origin)==0;
+#endif
+}
+
+#endif
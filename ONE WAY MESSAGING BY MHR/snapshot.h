@@ -0,0 +1,364 @@
+#ifndef SNAPSHOT
+#define SNAPSHOT
+
+#include "seek.h"
+#include<cstdio>
+#include<cstdint>
+#include<cstring>
+#include<string>
+#include<string_view>
+#include<vector>
+#include<memory>
+#include<unordered_map>
+#include<filesystem>
+
+#ifdef _WIN32
+#include<io.h>
+#else
+#include<unistd.h>
+#endif
+
+// Binary image of users and messages, loaded with one read at startup:
+//   SnapshotHeader | SnapshotString[names] | SnapshotUser[users]
+//   | SnapshotMessage[messages] | text
+// Records are fixed width. Usernames, passwords and roles are interned in
+// the names table; every string's bytes live in the text block.
+//
+// The header remembers how many bytes of users.csv and messages.log the
+// snapshot covers, plus a hash of the last few KB before that point. If a
+// file has only grown since, the snapshot is used and the new tail is read
+// from the text file. Anything else means the file was rewritten, and the
+// snapshot is ignored.
+
+struct SnapshotSource
+{
+    std::uint64_t size;
+    std::uint64_t tailHash;
+
+    static std::uint64_t hashTail(const std::string &path, std::uint64_t size)
+    {
+        char buf[4096];
+        std::uint64_t n=size<sizeof buf ? size : sizeof buf;
+        std::uint64_t h=14695981039346656037ull;
+        std::FILE* in=std::fopen(path.c_str(),"rb");
+        if(!in)
+        {
+            return h;
+        }
+        if(seekFile(in,size-n,SEEK_SET) && std::fread(buf,1,n,in)==n)
+        {
+            for(std::uint64_t i=0;i<n;i++)
+            {
+                h^=static_cast<unsigned char>(buf[i]);
+                h*=1099511628211ull;
+            }
+        }
+        std::fclose(in);
+        return h;
+    }
+
+    static SnapshotSource of(const std::string &path)
+    {
+        std::error_code ec;
+        std::uint64_t size=std::filesystem::file_size(path,ec);
+        if(ec)
+        {
+            size=0;
+        }
+        return {size, hashTail(path,size)};
+    }
+
+    // True when the file still starts with the bytes this snapshot covered.
+    bool covers(const std::string &path) const
+    {
+        std::error_code ec;
+        std::uint64_t now=std::filesystem::file_size(path,ec);
+        if(ec)
+        {
+            now=0;
+        }
+        return now>=size && hashTail(path,size)==tailHash;
+    }
+};
+
+struct SnapshotHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t nameCount;
+    std::uint64_t userCount;
+    std::uint64_t messageCount;
+    std::uint64_t textBytes;
+    SnapshotSource users;
+    SnapshotSource messages;
+};
+
+struct SnapshotString
+{
+    std::uint64_t offset;
+    std::uint32_t size;
+    std::uint32_t reserved;
+};
+
+struct SnapshotUser
+{
+    std::uint32_t username;
+    std::uint32_t password;
+    std::uint32_t role;
+    std::uint32_t reserved;
+};
+
+struct SnapshotMessage
+{
+    std::int64_t time;
+    std::uint32_t sender;
+    std::uint32_t receiver;
+    std::uint64_t content;
+    std::uint32_t contentSize;
+    std::uint32_t reserved;
+};
+
+static const char snapshotMagic[8]={'O','W','M','S','N','A','P','\0'};
+static const std::uint32_t snapshotVersion=1;
+
+// Collects records and writes them out in one pass. Strings are held as
+// views, so the users and messages passed in must outlive write().
+class SnapshotWriter
+{
+    private:
+    std::vector<std::string_view> names;
+    std::unordered_map<std::string_view, std::uint32_t> nameIds;
+    std::vector<SnapshotUser> users;
+    std::vector<SnapshotMessage> messages;
+    std::vector<std::string_view> contents;
+    std::uint64_t nameBytes=0, contentBytes=0;
+
+    std::uint32_t intern(std::string_view s)
+    {
+        auto [it, added]=nameIds.emplace(s, static_cast<std::uint32_t>(names.size()));
+        if(added)
+        {
+            names.push_back(s);
+            nameBytes+=s.size();
+        }
+        return it->second;
+    }
+
+    static bool put(std::FILE* out, const void* data, std::size_t size)
+    {
+        return size==0 || std::fwrite(data,1,size,out)==size;
+    }
+
+    public:
+    void addUser(const std::string &username, const std::string &password, const std::string &role)
+    {
+        users.push_back({intern(username), intern(password), intern(role), 0});
+    }
+
+    void addMessage(std::int64_t time, std::string_view sender, std::string_view receiver, std::string_view content)
+    {
+        messages.push_back({time, intern(sender), intern(receiver), contentBytes, static_cast<std::uint32_t>(content.size()), 0});
+        contents.push_back(content);
+        contentBytes+=content.size();
+    }
+
+    // Writes to path.tmp, syncs it and renames it over path.
+    bool write(const std::string &path, SnapshotSource usersSource, SnapshotSource messagesSource)
+    {
+        SnapshotHeader header{};
+        std::memcpy(header.magic, snapshotMagic, sizeof header.magic);
+        header.version=snapshotVersion;
+        header.nameCount=names.size();
+        header.userCount=users.size();
+        header.messageCount=messages.size();
+        header.textBytes=nameBytes+contentBytes;
+        header.users=usersSource;
+        header.messages=messagesSource;
+
+        // Names come first in the text block, message bodies after them.
+        std::vector<SnapshotString> refs;
+        refs.reserve(names.size());
+        std::uint64_t offset=0;
+        for(auto name:names)
+        {
+            refs.push_back({offset, static_cast<std::uint32_t>(name.size()), 0});
+            offset+=name.size();
+        }
+        for(auto &msg:messages)
+        {
+            msg.content+=nameBytes;
+        }
+
+        std::string tmp=path+".tmp";
+        std::FILE* out=std::fopen(tmp.c_str(),"wb");
+        if(!out)
+        {
+            return false;
+        }
+        bool ok=put(out,&header,sizeof header)
+            && put(out,refs.data(),refs.size()*sizeof(SnapshotString))
+            && put(out,users.data(),users.size()*sizeof(SnapshotUser))
+            && put(out,messages.data(),messages.size()*sizeof(SnapshotMessage));
+        for(std::size_t i=0;ok && i<names.size();i++)
+        {
+            ok=put(out,names[i].data(),names[i].size());
+        }
+        for(std::size_t i=0;ok && i<contents.size();i++)
+        {
+            ok=put(out,contents[i].data(),contents[i].size());
+        }
+        for(auto &msg:messages)
+        {
+            msg.content-=nameBytes;
+        }
+
+        ok=std::fflush(out)==0 && ok;
+#ifdef _WIN32
+        ok=_commit(_fileno(out))==0 && ok;
+#else
+        ok=fsync(fileno(out))==0 && ok;
+#endif
+        std::fclose(out);
+
+        std::error_code ec;
+        if(ok)
+        {
+            std::filesystem::rename(tmp,path,ec);
+        }
+        else
+        {
+            std::filesystem::remove(tmp,ec);
+        }
+        return ok && !ec;
+    }
+};
+
+// A whole snapshot read into memory with a single fread. open() checks the
+// header and every reference once, so the accessors need no checks.
+class SnapshotFile
+{
+    private:
+    std::unique_ptr<std::uint64_t[]> data; // 8-byte aligned storage for the records
+    const SnapshotHeader* head=nullptr;
+    const SnapshotString* nameRefs=nullptr;
+    const SnapshotUser* userRecords=nullptr;
+    const SnapshotMessage* messageRecords=nullptr;
+    const char* text=nullptr;
+
+    public:
+    bool open(const std::string &path)
+    {
+        std::error_code ec;
+        std::uint64_t size=std::filesystem::file_size(path,ec);
+        if(ec || size<sizeof(SnapshotHeader))
+        {
+            return false;
+        }
+
+        data.reset(new std::uint64_t[(size+7)/8]);
+        std::FILE* in=std::fopen(path.c_str(),"rb");
+        if(!in)
+        {
+            return false;
+        }
+        bool read=std::fread(data.get(),1,size,in)==size;
+        std::fclose(in);
+        if(!read)
+        {
+            return false;
+        }
+
+        const char* base=reinterpret_cast<const char*>(data.get());
+        head=reinterpret_cast<const SnapshotHeader*>(base);
+        if(std::memcmp(head->magic, snapshotMagic, sizeof head->magic)!=0 || head->version!=snapshotVersion)
+        {
+            return false;
+        }
+
+        // Each count is checked against the bytes left before multiplying,
+        // so a corrupt header cannot overflow the offsets.
+        std::uint64_t at=sizeof(SnapshotHeader);
+        auto take=[&](std::uint64_t count, std::uint64_t width) -> bool
+        {
+            if(count>(size-at)/width)
+            {
+                return false;
+            }
+            at+=count*width;
+            return true;
+        };
+        std::uint64_t names=at;
+        if(!take(head->nameCount,sizeof(SnapshotString)))
+        {
+            return false;
+        }
+        std::uint64_t users=at;
+        if(!take(head->userCount,sizeof(SnapshotUser)))
+        {
+            return false;
+        }
+        std::uint64_t messages=at;
+        if(!take(head->messageCount,sizeof(SnapshotMessage)) || size-at!=head->textBytes)
+        {
+            return false;
+        }
+        nameRefs=reinterpret_cast<const SnapshotString*>(base+names);
+        userRecords=reinterpret_cast<const SnapshotUser*>(base+users);
+        messageRecords=reinterpret_cast<const SnapshotMessage*>(base+messages);
+        text=base+at;
+
+        for(std::uint64_t i=0;i<head->nameCount;i++)
+        {
+            if(nameRefs[i].offset>head->textBytes || nameRefs[i].size>head->textBytes-nameRefs[i].offset)
+            {
+                return false;
+            }
+        }
+        for(std::uint64_t i=0;i<head->userCount;i++)
+        {
+            const SnapshotUser &u=userRecords[i];
+            if(u.username>=head->nameCount || u.password>=head->nameCount || u.role>=head->nameCount)
+            {
+                return false;
+            }
+        }
+        for(std::uint64_t i=0;i<head->messageCount;i++)
+        {
+            const SnapshotMessage &m=messageRecords[i];
+            if(m.sender>=head->nameCount || m.receiver>=head->nameCount
+                || m.content>head->textBytes || m.contentSize>head->textBytes-m.content)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const SnapshotHeader& header() const
+    {
+        return *head;
+    }
+
+    std::string_view name(std::uint32_t id) const
+    {
+        return std::string_view(text+nameRefs[id].offset, nameRefs[id].size);
+    }
+
+    const SnapshotUser& user(std::size_t i) const
+    {
+        return userRecords[i];
+    }
+
+    const SnapshotMessage& message(std::size_t i) const
+    {
+        return messageRecords[i];
+    }
+
+    std::string_view content(const SnapshotMessage &m) const
+    {
+        return std::string_view(text+m.content, m.contentSize);
+    }
+};
+
+#endif
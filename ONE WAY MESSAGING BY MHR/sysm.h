@@ -2,10 +2,15 @@
 #define SYSTEM_MANAGER
 
 #include "msg.h"
+#include "intern.h"
+#include "msglog.h"
+#include "snapshot.h"
 #include "user.h"
 #include<vector>
+#include<unordered_map>
 #include<fstream>
 #include<sstream>
+#include<algorithm>
 
 
 
@@ -14,9 +19,61 @@ class SystemManager
     private:
     std::vector<User*>users;
     std::vector<Message>messages;
+    NameTable names;   // senders and receivers
+    Arena bodies;      // message contents
+    SnapshotFile snapshot; // kept open: messages loaded from it point into it
+    MessageLog messageLog{"messages.log"};
+    const std::string snapshotPath="snapshot.bin";
+    std::vector<std::vector<std::size_t>> inbox; //receiver name id -> message indices, oldest first
+
+    // Stores a message whose content already lives in bodies or snapshot.
+    // Messages nearly always arrive in time order, so the inbox stays sorted
+    // by appending; an older one (clock change, merged log) is inserted.
+    void storeMessage(std::uint32_t sender, std::uint32_t receiver, std::string_view content, std::time_t time)
+    {
+        messages.emplace_back(sender,receiver,content,time);
+        if(receiver>=inbox.size())
+        {
+            inbox.resize(names.size());
+        }
+        std::vector<std::size_t> &received=inbox[receiver];
+        if(received.empty() || messages[received.back()].getTimestamp()<=time)
+        {
+            received.push_back(messages.size()-1);
+            return;
+        }
+        auto at=std::upper_bound(received.begin(),received.end(),time,
+            [this](std::time_t t, std::size_t i){ return t<messages[i].getTimestamp(); });
+        received.insert(at,messages.size()-1);
+    }
+
+    static std::string_view previewOf(std::string_view content)
+    {
+        std::size_t end=std::min(content.find('\n'),previewLength);
+        end=std::min(end,content.size());
+        if(end<content.size())
+        {
+            while(end>0 && (static_cast<unsigned char>(content[end])&0xC0)==0x80)
+            {
+                end--; // do not cut a UTF-8 character in half
+            }
+        }
+        return content.substr(0,end);
+    }
+
+    void addMessage(const MessageView &msg)
+    {
+        std::uint32_t sender=names.intern(msg.getSender());
+        std::uint32_t receiver=names.intern(msg.getReceiver());
+        storeMessage(sender,receiver,bodies.copy(msg.getContent()),msg.getTimestamp());
+    }
 
     User* currentUser=nullptr;
 
+    static User* createUser(const std::string &username, const std::string &password, const std::string &role);
+
+    bool loadSnapshot();
+
     bool userExists(const std::string &username) //issues
     {
         for(auto user:users)
@@ -57,12 +114,18 @@ class SystemManager
 
     void saveUsersToFile();
 
-    void loadUsersFromFile();
+    void loadUsersFromFile(std::streamoff from=0);
 
     void saveMessagesToFile();
 
     void loadMessagesFromFile();
 
+    // Startup: the snapshot plus whatever was appended after it, or the
+    // text files when there is no usable snapshot.
+    void load();
+
+    bool saveSnapshot();
+
     bool isLoggedIn()
     {
         return currentUser!=nullptr;
@@ -73,6 +136,62 @@ class SystemManager
         return currentUser;
     }
 
+    const std::vector<std::size_t>& inboxFor(const std::string &username) const
+    {
+        static const std::vector<std::size_t> empty;
+        std::uint32_t id=names.find(username);
+        return id<inbox.size() ? inbox[id] : empty;
+    }
+
+    std::size_t messageCount() const
+    {
+        return messages.size();
+    }
+
+    MessageView messageAt(std::size_t i) const
+    {
+        const Message &msg=messages[i];
+        return MessageView{names.view(msg.getSender()), names.view(msg.getReceiver()), msg.getContent(), msg.getTimestamp()};
+    }
+
+    static constexpr std::size_t inboxPageSize=10;
+    static constexpr std::size_t previewLength=48;
+
+    // Page `page` (from 0) of username's inbox, newest message first. Only
+    // the headers on the page are built, so the cost does not depend on how
+    // many messages the user has. Empty past the last page.
+    std::vector<MessageHeader> inboxPage(const std::string &username, std::size_t page, std::size_t pageSize=inboxPageSize) const
+    {
+        std::vector<MessageHeader> headers;
+        const std::vector<std::size_t> &received=inboxFor(username);
+        if(pageSize==0 || page>=(received.size()+pageSize-1)/pageSize)
+        {
+            return headers;
+        }
+        std::size_t newest=received.size()-page*pageSize;
+        std::size_t oldest=newest>pageSize ? newest-pageSize : 0;
+        headers.reserve(newest-oldest);
+        for(std::size_t pos=newest; pos>oldest; pos--)
+        {
+            std::size_t id=received[pos-1];
+            const Message &msg=messages[id];
+            std::string_view preview=previewOf(msg.getContent());
+            headers.push_back(MessageHeader{id, names.view(msg.getSender()), msg.getTimestamp(), preview, preview.size()<msg.getContent().size()});
+        }
+        return headers;
+    }
+
+    // The full message behind a header, if it was sent to username.
+    bool openMessage(const std::string &username, std::size_t id, MessageView &out) const
+    {
+        if(id>=messages.size() || messages[id].getReceiver()!=names.find(username))
+        {
+            return false;
+        }
+        out=messageAt(id);
+        return true;
+    }
+
 };
 
 void Student::displayDashboard(SystemManager &sys) //issues
@@ -167,7 +286,7 @@ void Admin::displayDashboard(SystemManager &sys) //issues
     do
     {
         system("cls");
-        std::cout<<"\n ADMIN DASHBOARD\n1. View Inbox\n2. Send Message\n3. Logout\nChoice: ";
+        std::cout<<"\n ADMIN DASHBOARD\n1. View Inbox\n2. Send Message\n3. Save Snapshot\n4. Logout\nChoice: ";
         std::cin>>choice;
 
         switch(choice)
@@ -194,6 +313,13 @@ void Admin::displayDashboard(SystemManager &sys) //issues
             }
 
             case 3:
+            {
+                std::cout<<(sys.saveSnapshot() ? "Snapshot saved!\n" : "Snapshot could not be saved!\n");
+                sys.pauseScreen();
+                break;
+            }
+
+            case 4:
             {
                 sys.logout();
                 break;
@@ -299,8 +425,14 @@ void SystemManager::sendMessage(std::string receiver,std::string content)
         return;
     }
 
-    messages.emplace_back(currentUser->getUsername(), receiver, content);
-    saveMessagesToFile();
+    MessageView msg{currentUser->getUsername(), receiver, content, time(nullptr)};
+    if(!messageLog.append(msg))
+    {
+        std::cout<<"Message could not be saved!\n";
+        pauseScreen();
+        return;
+    }
+    addMessage(msg);
     std::cout<<"Message Sent!\n";
     pauseScreen();
 
@@ -313,29 +445,58 @@ void SystemManager::viewInbox()
         return;
     }
 
-    std::string username=currentUser->getUsername();
-    bool found=false;
+    const std::string &username=currentUser->getUsername();
+    std::size_t total=inboxFor(username).size();
+    if(total==0)
+    {
+        std::cout<<"No Messages found!\n";
+        pauseScreen();
+        return;
+    }
 
-    for(auto &msg:messages)
+    std::size_t pages=(total+inboxPageSize-1)/inboxPageSize;
+    std::size_t page=0;
+    while(true)
     {
-        if(msg.getReceiver()==username)
+        system("cls");
+        std::vector<MessageHeader> headers=inboxPage(username,page);
+        std::cout<<"\n INBOX - page "<<page+1<<" of "<<pages<<" ("<<total<<" messages, newest first)\n";
+        for(std::size_t i=0; i<headers.size(); i++)
         {
-            time_t timestamp = msg.getTimestamp();
-
-            std::cout<<"From: "<<msg.getSender()<<"\nContent: "
-            <<msg.getContent()<<"\nTime: "<<ctime(&timestamp)
-            <<"------------------------------------------\n";
-
-            found=true;
+            char when[32];
+            std::strftime(when,sizeof when,"%Y-%m-%d %H:%M",std::localtime(&headers[i].timestamp));
+            std::cout<<i+1<<". "<<when<<"  "<<headers[i].sender<<": "<<headers[i].preview
+            <<(headers[i].truncated ? "..." : "")<<"\n";
+        }
+        std::cout<<"\nNumber to open, n = next, p = previous, q = back\nChoice: ";
 
+        std::string choice;
+        if(!(std::cin>>choice) || choice=="q")
+        {
+            return;
+        }
+        if(choice=="n")
+        {
+            page=std::min(page+1,pages-1);
+            continue;
+        }
+        if(choice=="p")
+        {
+            page=page>0 ? page-1 : 0;
+            continue;
         }
-    }
 
-    if(!found)
-    {
-        std::cout<<"No Messages found!\n";
+        std::size_t index=std::strtoul(choice.c_str(),nullptr,10);
+        MessageView msg;
+        if(index<1 || index>headers.size() || !openMessage(username,headers[index-1].id,msg))
+        {
+            continue;
+        }
+        time_t timestamp = msg.getTimestamp();
+        std::cout<<"\nFrom: "<<msg.getSender()<<"\nTime: "<<ctime(&timestamp)
+        <<"Content: "<<msg.getContent()<<"\n------------------------------------------\n";
+        pauseScreen();
     }
-    pauseScreen();
 
 }
 
@@ -351,10 +512,28 @@ void SystemManager::saveUsersToFile()
 
 }
 
-void SystemManager::loadUsersFromFile()
+User* SystemManager::createUser(const std::string &username, const std::string &password, const std::string &role)
+{
+    if(role=="student")
+    {
+        return new Student(username,password);
+    }
+    else if(role=="faculty")
+    {
+        return new Faculty(username,password);
+    }
+    else if(role=="admin")
+    {
+        return new Admin(username,password);
+    }
+    return nullptr;
+}
+
+void SystemManager::loadUsersFromFile(std::streamoff from)
 {
     std::ifstream file("users.csv");
     std::string line;
+    file.seekg(from);
 
     while(getline(file,line))
     {
@@ -365,20 +544,7 @@ void SystemManager::loadUsersFromFile()
         getline(ss, password,',');
         getline(ss, role,',');
 
-        User* user = nullptr;
-
-        if(role=="student")
-        {
-            user= new Student(username,password); 
-        }
-        else if(role=="faculty")
-        {
-            user= new Faculty(username,password); 
-        }
-        else if(role=="admin")
-        {
-            user= new Admin(username,password); 
-        }
+        User* user=createUser(username,password,role);
 
         if(user)
         {
@@ -391,17 +557,24 @@ void SystemManager::loadUsersFromFile()
 
 void SystemManager::saveMessagesToFile()
 {
-    std::ofstream file("messages.csv");
-    for(auto &msg:messages)
+    messageLog.rewrite(messages.size(), [this](std::size_t i)
     {
-        file<<msg.getSender()<<"|"<<msg.getReceiver()<<"|"
-        <<msg.getContent()<<"|"<<msg.getTimestamp()<<"\n";
-    }
-
+        return messageAt(i);
+    });
 }
 
 void SystemManager::loadMessagesFromFile()
 {
+    if(messageLog.exists())
+    {
+        messageLog.replay([this](const MessageView &msg)
+        {
+            addMessage(msg);
+        });
+        return;
+    }
+
+    // First run on an old install: import messages.csv into the log.
     std::ifstream file("messages.csv");
     std::string line;
 
@@ -417,11 +590,91 @@ void SystemManager::loadMessagesFromFile()
 
         time_t timestamp=std::stol(timeStr);
 
-        messages.emplace_back(sender, receiver, content, timestamp);
+        addMessage(MessageView{sender, receiver, content, timestamp});
+
+    }
+
+    if(!messages.empty())
+    {
+        saveMessagesToFile();
+    }
+
+}
+
+bool SystemManager::loadSnapshot()
+{
+    SnapshotFile file;
+    if(!file.open(snapshotPath))
+    {
+        return false;
+    }
+    const SnapshotHeader &header=file.header();
+    if(!header.users.covers("users.csv") || !header.messages.covers(messageLog.filePath()))
+    {
+        return false;
+    }
+    snapshot=std::move(file);
+
+    users.reserve(header.userCount);
+    for(std::size_t i=0;i<header.userCount;i++)
+    {
+        const SnapshotUser &u=snapshot.user(i);
+        User* user=createUser(std::string(snapshot.name(u.username)), std::string(snapshot.name(u.password)),
+            std::string(snapshot.name(u.role)));
+        if(user)
+        {
+            users.push_back(user);
+        }
+    }
 
+    // Snapshot name ids map onto ours on first use; bodies stay where they
+    // are in the snapshot's text block.
+    std::vector<std::uint32_t> ids(header.nameCount, NameTable::none);
+    auto idFor=[&](std::uint32_t id)
+    {
+        if(ids[id]==NameTable::none)
+        {
+            ids[id]=names.intern(snapshot.name(id));
+        }
+        return ids[id];
+    };
+    messages.reserve(header.messageCount);
+    for(std::size_t i=0;i<header.messageCount;i++)
+    {
+        const SnapshotMessage &m=snapshot.message(i);
+        storeMessage(idFor(m.sender), idFor(m.receiver), snapshot.content(m), static_cast<std::time_t>(m.time));
     }
 
+    loadUsersFromFile(static_cast<std::streamoff>(header.users.size));
+    messageLog.replay([this](const MessageView &msg)
+    {
+        addMessage(msg);
+    }, header.messages.size);
+    return true;
+}
 
+void SystemManager::load()
+{
+    if(!loadSnapshot())
+    {
+        loadUsersFromFile();
+        loadMessagesFromFile();
+    }
+}
+
+bool SystemManager::saveSnapshot()
+{
+    SnapshotWriter writer;
+    for(auto user:users)
+    {
+        writer.addUser(user->username,user->password,user->role);
+    }
+    for(std::size_t i=0;i<messages.size();i++)
+    {
+        MessageView msg=messageAt(i);
+        writer.addMessage(msg.getTimestamp(),msg.getSender(),msg.getReceiver(),msg.getContent());
+    }
+    return writer.write(snapshotPath, SnapshotSource::of("users.csv"), SnapshotSource::of(messageLog.filePath()));
 }
 
 #endif
\ No newline at end of file
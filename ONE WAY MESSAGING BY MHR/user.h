@@ -29,12 +29,12 @@ class User
 
     virtual void displayDashboard(SystemManager &sys)=0;
     
-    std::string getUsername() const
+    const std::string& getUsername() const
     {
         return username;
     }
     
-    std::string getRole() const
+    const std::string& getRole() const
     {
         return role;
     }